@@ -14,5 +14,8 @@ DEFINES	+= _DEBUG=1
 INCLUDEPATH	+= ../SecurityCode/vCloud/
 INCLUDEPATH	+= ./
 
+LIBS	+= -lpthread -ldl
+
 HEADERS += \
-    cli_routines.h
+    cli_routines.h \
+    cli_routines.hpp
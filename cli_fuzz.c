@@ -0,0 +1,277 @@
+#define	__MODULE__	"CLI_FUZZ"
+#define	__IDENT__	"X.00-01"
+
+/*
+**++
+**
+**  FACILITY:  Command Language Interface (CLI) Routines
+**
+**  ABSTRACT: Fuzzing of the cli$parse() against input limits.
+**
+**  DESCRIPTION: Every command line is parsed under tight CLI_LIMITS. A parse must be completed in bounded
+**	time, memory accounting must stay within the limits and must return to the initial value after cleanup,
+**	oversized input must be rejected with the proper reason.
+**
+**	libFuzzer target: an input is split into arguments by NUL octets,
+**		clang -g -O1 -fsanitize=fuzzer,address -D__CLI_LIBFUZZER__ cli_fuzz.c cli_routines.c ...
+**
+**	Standalone (cli_fuzz.pro): random command lines are built from pieces of the verbs table
+**	and random octets,
+**		cli_fuzz [<iterations> [<seed>]]
+**
+**  AUTHORS: Ruslan R. Laishev (RRL)
+**
+**  CREATION DATE:  19-OCT-2026
+**
+**  MODIFICATION HISTORY:
+**
+**--
+*/
+
+#include	<string.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<time.h>
+
+#define		__FAC__	"CLI_FUZZ"
+#define		__TFAC__ __FAC__ ": "
+#include	"utility_routines.h"
+#include	"cli_routines.h"
+
+#define	FUZZ$K_MAXARGC	32		/* Limits are applied to the parser	*/
+#define	FUZZ$K_MAXBYTES	4096
+#define	FUZZ$K_CTXMEM	(64 * 1024)
+#define	FUZZ$K_GLOBMEM	(256 * 1024)
+
+#define	FUZZ$K_MAXNS	(20 * 1000000ULL)	/* Time bound of a single parse	*/
+#define	FUZZ$K_ARGSZ	(4 * FUZZ$K_MAXBYTES)	/* Maximum length of an argument	*/
+
+static	CLI_KEYWORD	fuzz_kwds [] = {
+			{ {$ASCINI("FULL")}, 1},
+			{ {$ASCINI("FAST")}, 2},
+			{ {$ASCINI("TRACE")}, 4},
+			{0}};
+
+static	CLI_PQDESC	fuzz_params [] = {
+			{.pn = CLI$K_P1, .type = CLI$K_NUM, .name = {$ASCINI("Count")} },
+			{.pn = CLI$K_P2, .type = CLI$K_QSTRING, .name = {$ASCINI("Text")} },
+			{0}},
+		fuzz_quals [] = {
+			{ .name = {$ASCINI("LOG")},	.type = CLI$K_OPT},
+			{ .name = {$ASCINI("LOGGING")},	.type = CLI$K_KWD, .flag = CLI$M_LIST, .kwd = fuzz_kwds},
+			{ .name = {$ASCINI("LOGFILE")},	.type = CLI$K_FILE},
+			{ .name = {$ASCINI("START")},	.type = CLI$K_NUM},
+			{ .name = {$ASCINI("ADDRESS")},	.type = CLI$K_IPV4},
+			{ .name = {$ASCINI("ID")},	.type = CLI$K_UUID},
+			{ .name = {$ASCINI("SINCE")},	.type = CLI$K_DATE},
+			{0}};
+
+static	CLI_VERB	fuzz_subverbs [] = {
+			{ .name = {$ASCINI("volume")}, .params = fuzz_params, .quals = fuzz_quals},
+			{ .name = {$ASCINI("volumes")}, .quals = fuzz_quals},
+			{0}},
+		fuzz_verbs [] = {
+			{ .name = {$ASCINI("set")}, .next = fuzz_subverbs},
+			{ .name = {$ASCINI("setup")}, .quals = fuzz_quals},
+			{ .name = {$ASCINI("show")}, .next = fuzz_subverbs},
+			{ .name = {$ASCINI("diff")}, .params = fuzz_params, .quals = fuzz_quals},
+			{0}};
+
+static	const char	*fuzz_words [] = {"set", "setup", "se", "show", "sh", "diff", "volume", "volumes", "vol",
+			"/log", "/logging=(full,trace)", "/logging=fa", "/logf=x.log", "/lo", "/start=0x10",
+			"/address=10.0.0.1", "/id=6e9c0f6e-27c3-4ff1-8b61-4d0d6a1f6b9a", "/since=01-01-2026",
+			"-log", "/", "=", "42", "\"text\"", "\"", "(", ",", ")"};
+
+static	unsigned long long fuzz_seed = 0x9e3779b97f4a7c15ULL;
+static	int	fuzz_parsed, fuzz_rejected;	/* Successfully parsed, rejected by limits */
+
+/* xorshift64*, reproducible by the seed */
+static	unsigned long long fuzz_rand	(void)
+{
+	fuzz_seed ^= fuzz_seed >> 12;
+	fuzz_seed ^= fuzz_seed << 25;
+	fuzz_seed ^= fuzz_seed >> 27;
+
+	return	fuzz_seed * 0x2545f4914f6cdd1dULL;
+}
+
+static	unsigned long long fuzz_now	(void)
+{
+struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return	ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Fill an argument by a word, random octets or a long run, return a length of the argument */
+static	int	fuzz_arg	(char *buf)
+{
+int	len, i;
+
+	switch ( fuzz_rand() % 8 )
+		{
+		case	0:
+		case	1:
+		case	2:
+		case	3:
+		case	4:
+			len = snprintf(buf, FUZZ$K_ARGSZ + 1, "%s", fuzz_words[fuzz_rand() % (sizeof(fuzz_words) / sizeof(fuzz_words[0]))]);
+			break;
+
+		case	5:
+		case	6:
+			for ( len = fuzz_rand() % 64, i = 0; i < len; i++)
+				buf[i] = 1 + fuzz_rand() % 255;
+			break;
+
+		default:
+			len = fuzz_rand() % (FUZZ$K_ARGSZ + 1);
+			memset(buf, "/xa=("[fuzz_rand() % 5], len);
+		}
+
+	buf[len] = '\0';
+
+	return	len;
+}
+
+/* Parse the command line and check the time and memory bounds, return a number of failed checks */
+static	int	fuzz_check	(int argc, char **argv, int iter)
+{
+int	status, fails = 0, toolong, i;
+size_t	bytes;
+CLI_CTX	*clictx = NULL;
+CLI_MSTAT gm0, gm, cm;
+unsigned long long t0, t1;
+
+	for ( bytes = 0, i = 0; i < argc; i++)
+		bytes += strlen(argv[i]);
+
+	toolong = bytes > FUZZ$K_MAXBYTES;
+
+	cli$get_memstat(NULL, &gm0);
+
+	t0 = fuzz_now();
+	status = cli$parse(fuzz_verbs, 0, argc, argv, (void **) &clictx);
+	t1 = fuzz_now();
+
+	if ( t1 - t0 > FUZZ$K_MAXNS )
+		fails++, fprintf(stderr, "#%d: parse of %d arguments (%zu octets) took %llu nsecs\n", iter, argc, bytes, t1 - t0);
+
+	if ( !clictx )
+		return	fails + (fprintf(stderr, "#%d: no context, status=%d\n", iter, status), 1);
+
+	cli$get_memstat(clictx, &cm);
+	cli$get_memstat(NULL, &gm);
+
+	if ( (cm.bytes > FUZZ$K_CTXMEM) || (gm.bytes > FUZZ$K_GLOBMEM) )
+		fails++, fprintf(stderr, "#%d: memory limits exceeded: %llu in context, %llu total\n", iter, cm.bytes, gm.bytes);
+
+	if ( (argc > FUZZ$K_MAXARGC) && ((1 & status) || (clictx->err.reason != CLI$K_ERR_MAXARGC)) )
+		fails++, fprintf(stderr, "#%d: %d arguments are accepted, reason=%d\n", iter, argc, clictx->err.reason);
+	else if ( (argc <= FUZZ$K_MAXARGC) && toolong && ((1 & status) || (clictx->err.reason != CLI$K_ERR_MAXBYTES)) )
+		fails++, fprintf(stderr, "#%d: %zu octets are accepted, reason=%d\n", iter, bytes, clictx->err.reason);
+
+	/* Nothing is reserved for a rejected input */
+	if ( (argc > FUZZ$K_MAXARGC || toolong) && cm.bytes )
+		fails++, fprintf(stderr, "#%d: rejected input holds %llu octets\n", iter, cm.bytes);
+
+	fuzz_parsed += (1 & status);
+	fuzz_rejected += (argc > FUZZ$K_MAXARGC || toolong);
+
+	cli$cleanup(clictx);
+
+	cli$get_memstat(NULL, &gm);
+
+	if ( gm.bytes != gm0.bytes )
+		fails++, fprintf(stderr, "#%d: %lld octets are left after cleanup\n", iter, (long long) (gm.bytes - gm0.bytes));
+
+	return	fails;
+}
+
+static	void	fuzz_limits	(void)
+{
+CLI_LIMITS limits = {.maxargc = FUZZ$K_MAXARGC, .maxbytes = FUZZ$K_MAXBYTES, .ctxmem = FUZZ$K_CTXMEM, .globmem = FUZZ$K_GLOBMEM};
+
+	cli$set_limits(&limits);
+}
+
+/*
+ * libFuzzer entry: arguments are separated by NUL octets, arguments over 2 * FUZZ$K_MAXARGC
+ * are dropped; a failed check is a crash
+ */
+int	LLVMFuzzerInitialize	(int *argc, char ***argv)
+{
+	fuzz_limits();
+
+	return	0;
+}
+
+int	LLVMFuzzerTestOneInput	(const unsigned char *data, size_t size)
+{
+static	int	iter;
+char	*buf, *cp, *ep, *fargv[2 * FUZZ$K_MAXARGC];
+int	argc = 0;
+
+	if ( !(buf = malloc(size + 1)) )
+		return	0;
+
+	memcpy(buf, data, size);
+	buf[size] = '\0';
+
+	for ( cp = buf, ep = buf + size; (cp < ep) && (argc < 2 * FUZZ$K_MAXARGC); cp += strlen(cp) + 1)
+		fargv[argc++] = cp;
+
+	if ( fuzz_check(argc, fargv, iter++) )
+		abort();
+
+	free(buf);
+
+	return	0;
+}
+
+static	int	fuzz_one	(char **argv, char *args, int iter)
+{
+int	argc, i;
+
+	/* Mostly short lines, oversized ones are rejected at once */
+	argc = 1 + fuzz_rand() % ((fuzz_rand() % 8) ? 6 : 2 * FUZZ$K_MAXARGC);
+
+	for ( i = 0; i < argc; i++)
+		{
+		argv[i] = args + i * (FUZZ$K_ARGSZ + 1);
+		fuzz_arg(argv[i]);
+		}
+
+	return	fuzz_check(argc, argv, iter);
+}
+
+#ifndef	__CLI_LIBFUZZER__
+int	main	(int argc, char **argv)
+{
+int	i, iters = 20000, fails = 0;
+char	*args, *fargv[2 * FUZZ$K_MAXARGC];
+
+	if ( argc > 1 )
+		iters = atoi(argv[1]);
+
+	if ( argc > 2 )
+		fuzz_seed = strtoull(argv[2], NULL, 0);
+
+	fprintf(stdout, "Iterations: %d, seed: %#llx\n", iters, fuzz_seed);
+
+	if ( !(args = malloc(2 * FUZZ$K_MAXARGC * (FUZZ$K_ARGSZ + 1))) )
+		return	perror("malloc"), 1;
+
+	fuzz_limits();
+
+	for ( i = 0; (i < iters) && (fails < 16); i++)
+		fails += fuzz_one(fargv, args, i);
+
+	free(args);
+
+	fprintf(stdout, "%s, %d iterations, %d parsed, %d rejected by limits\n", fails ? "FAILED" : "OK", i, fuzz_parsed, fuzz_rejected);
+
+	return	!!fails;
+}
+#endif	/* !__CLI_LIBFUZZER__ */
@@ -0,0 +1,19 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = cli_fuzz
+
+SOURCES += \
+    cli_fuzz.c \
+    cli_routines.c \
+    ../SecurityCode/vCloud/utility_routines.c
+
+INCLUDEPATH	+= ../SecurityCode/vCloud/
+INCLUDEPATH	+= ./
+
+LIBS	+= -lpthread -ldl
+
+HEADERS += \
+    cli_routines.h
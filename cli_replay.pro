@@ -0,0 +1,20 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = cli_replay
+
+SOURCES += \
+    cli_routines.c \
+    ../SecurityCode/vCloud/utility_routines.c
+
+DEFINES	+= __CLI_REPLAY__=1
+
+INCLUDEPATH	+= ../SecurityCode/vCloud/
+INCLUDEPATH	+= ./
+
+LIBS	+= -lpthread -ldl
+
+HEADERS += \
+    cli_routines.h
@@ -47,16 +47,88 @@
 **
 **	15-OCT-2018	RRL	A main part of code has been wrote; split CLI API to .C and .H modules.
 **
+**	19-OCT-2026	RRL	Added runtime-mutable command tables (cli$tbl_*) with lock-free readers;
+**				fixed subverb's parsing in the _cli$parse_verb().
+**
+**	19-OCT-2026	RRL	Added verb's stubs are bound to a shared object at first use.
+**
+**	19-OCT-2026	RRL	Parsing cost is linear in input size: O(1) list appending, stop on exact qualifier's
+**				match, single pass over subverbs in cli$show_verbs(); added input limits (cli$set_limits).
+**
+**	19-OCT-2026	RRL	Values are checked by cli$val_check() at insertion into the context; added incremental
+**				parser's session (cli$ses_*) to re-match and re-validate only changed tokens.
+**
+**	19-OCT-2026	RRL	Parsing failures are recorded into the CLI_ERR structure of the context,
+**				message formatting is deferred to cli$format_error().
+**
+**	19-OCT-2026	RRL	Added multi-threaded dry-run validation of command scripts (cli$validate_file).
+**
+**	19-OCT-2026	RRL	Added SSE2/AVX2 command text lexer (cli$lex) with runtime dispatching.
+**
+**	19-OCT-2026	RRL	Added list-valued parameters (CLI$M_LIST) are streamed from response files (cli$list_*).
+**
+**	19-OCT-2026	RRL	Added per-context and global memory accounting and limits (cli$get_memstat).
+**
+**	19-OCT-2026	RRL	Added cached help/JSON schema rendering (cli$render_help), cli$show_verbs()
+**				emits a whole table by single $LOG.
+**
+**	19-OCT-2026	RRL	Added C++ wrapper (cli_routines.hpp), fixed UUID value check.
+**
+**	19-OCT-2026	RRL	Added command deadlines and cooperative cancellation (cli$check_cancel),
+**				cli$dispatch_timed().
+**
+**	19-OCT-2026	RRL	Added buffered structured output sink (cli$set_output, cli$put_output),
+**				cli$show_ctx() and SHOW USER are routed through it.
+**
+**	19-OCT-2026	RRL	Added TTL result cache for idempotent verbs (CLI$M_VERB_IDEMPOTENT).
+**
+**	19-OCT-2026	RRL	Added priority-class scheduler of commands (cli$sched_*).
+**
+**	19-OCT-2026	RRL	Sample DIFF command compares files/volumes by LBN ranges: multithreaded,
+**				SIMD block comparison, differing ranges are reported through the output sink.
+**
+**	19-OCT-2026	RRL	Sample SHOW VOLUME enumerates block devices from /sys/block with cached
+**				snapshot and UUID index; DEVICE values can be wildcards.
+**
+**	19-OCT-2026	RRL	Added recording of the command traffic (cli$record_*) and replay (cli$replay),
+**				cli_replay.pro builds a replay utility (__CLI_REPLAY__).
+**
+**	19-OCT-2026	RRL	Added deferred checking of values (CLI$M_OPDEFERVAL, cli$validate) and
+**				pipelined parse/validate/dispatch executor on SPSC rings (cli$pipe_*).
+**
+**	19-OCT-2026	RRL	Added context pool (cli$ctx_pool) with per-thread caches and lock-free freelist,
+**				contexts have preallocated items.
+**
 **--
 */
 
+#ifndef	_GNU_SOURCE
+#define	_GNU_SOURCE			/* pthread_setaffinity_np()	*/
+#endif
+
 #include	<string.h>
 #include	<stdio.h>
+#include	<stdarg.h>
 #include	<stdlib.h>
+#include	<stddef.h>
 #include	<errno.h>
+#include	<limits.h>
 #include	<time.h>
 #include	<sys/stat.h>
 #include	<arpa/inet.h>
+#include	<pthread.h>
+#include	<sched.h>
+#include	<dlfcn.h>
+#include	<fcntl.h>
+#include	<unistd.h>
+#include	<sys/mman.h>
+#include	<sys/uio.h>
+#include	<sys/socket.h>
+#include	<poll.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include	<immintrin.h>
+#endif
 
 /*
 * Defines and includes for enable extend trace and logging
@@ -76,6 +148,22 @@
 #define $SHOW_BOOL(var)			$SHOW_PARM(var, (var ? "ENABLED(TRUE)" : "DISABLED(FALSE)"), "%s");
 
 
+static	pthread_mutex_t	cli$plugin_lock = PTHREAD_MUTEX_INITIALIZER;
+static	unsigned	cli$verbs_gen;	/* Bumped on stub's binding and CLI_TABLE's update, see cli$render_help() */
+
+static	CLI_LIMITS	cli$limits = { .maxargc = CLI$K_MAXARGC, .maxbytes = CLI$K_MAXBYTES };
+static	CLI_MSTAT	cli$gmstat;	/* Memory accounting of all contexts	*/
+
+static	int	cli$check_keyword (CLI_CTX *clictx, char *sts, int len, CLI_KEYWORD *klist, CLI_KEYWORD **kwd);
+static	int	_cli$out_close (CLI_CTX *clictx);
+static	int	_cli$cache_dispatch (CLI_CTX *clictx, CLI_VERB *verb);
+static	CLI_VERB *_cli$plugin_find (CLI_VERB *verb);
+static	unsigned long long _cli$now (clockid_t clk);
+static	void	_cli$rec_parse	(CLI_CTX *clictx, int argc, char **argv, int status, unsigned long long t0);
+static	void	_cli$rec_commit	(CLI_CTX *clictx);
+
+static	int	cli$rec_fd = -1;	/* Traffic log, see cli$record_start()	*/
+
 static	char *cli$val_type	(
 			int	valtype
 		)
@@ -90,6 +178,7 @@ static	char *cli$val_type	(
 		case	CLI$K_OPT:	return	"OPTION (no value)";
 		case	CLI$K_QSTRING:	return	"ASCII string in double quotes";
 		case	CLI$K_UUID:	return	"UUID ( ... )";
+		case	CLI$K_DEVICE:	return	"DEVICE (sdb, sdb1, /dev/sda5, sd*)";
 		case	CLI$K_KWD:	return	"KEYWORD";
 		}
 
@@ -98,815 +187,7600 @@ static	char *cli$val_type	(
 
 /*
  *
- *  DESCRIPTION: Check a input value for the parameter/qualifier corresponding has been declared type
-
+ *  DESCRIPTION: format a message text for the error record of the CLI-context.
  *
  *  INPUT:
- *	clictx:	CLI-context has been created by cli$parse()
- *	pqdesc:	Parameter/Qualifier descriptor
- *	val:	an ASCIC string to be checked
+ *	clictx:	A CLI-context
+ *	buf:	a buffer to accept message
+ *	bufsz:	a size of the buffer
  *
  *  RETURN:
- *	SS$_NORMAL, condition status
+ *	a length of the message (see snprintf())
  *
  */
-static	int	cli$val_check	(
-		CLI_CTX		*clictx,
-		CLI_PQDESC	*pqdesc,
-			ASC	*val
-				)
+int	cli$format_error	(
+		CLI_CTX	*clictx,
+		char	*buf,
+		int	bufsz
+			)
 {
-unsigned long long int	status = -1;
-char	buf[NAME_MAX], *cp;
+CLI_ERR	*err = &clictx->err;
+ASC	*name = err->desc, *alt = err->alt;	/* A name is the first member of CLI_VERB, CLI_PQDESC and CLI_KEYWORD */
+char	*what;
 
-	switch (pqdesc->type)
+	what = !err->dtype ? "verb" : (err->dtype == CLI$K_QUAL) ? "qualifier" : (err->dtype == CLI$K_KWD) ? "keyword" : "parameter";
+
+	switch ( err->reason )
 		{
-		case	CLI$K_IPV4:
-		case	CLI$K_IPV6:
-			if ( 1 !=  inet_pton(pqdesc->type == CLI$K_IPV4 ? AF_INET : AF_INET6, $ASCPTR(val), buf) )
-				return	(clictx->opts & CLI$M_OPSIGNAL)
-					? $LOG(STS$K_ERROR, "Value '%.*s' cannot be converted, errno=%d", $ASC(val), errno)
-					: STS$K_ERROR;
-			break;
+		case	CLI$K_ERR_NONE:
+			return	snprintf(buf, bufsz, "No error");
 
-		case	CLI$K_NUM:
-			strtoull($ASCPTR(val), &cp, 0);
+		case	CLI$K_ERR_NOVERB:
+			return	snprintf(buf, bufsz, "Missing command verb, argument #%d", err->tokidx);
 
-			if (errno == ERANGE )
-				return	(clictx->opts & CLI$M_OPSIGNAL)
-					? $LOG(STS$K_ERROR, "Value '%.*s' cannot be converted, errno=%d", $ASC(val), errno)
-					: STS$K_ERROR;
+		case	CLI$K_ERR_AMBIGUOUS:
+			return	snprintf(buf, bufsz, "Ambiguous input '%.*s' (matched to : '%.*s', '%.*s'), argument #%d, offset %d",
+				$ASC(&err->text), $ASC(name), $ASC(alt), err->tokidx, err->offset);
 
-			break;
+		case	CLI$K_ERR_UNRECOGNIZED:
+			return	snprintf(buf, bufsz, "Unrecognized %s '%.*s', argument #%d, offset %d",
+				what, $ASC(&err->text), err->tokidx, err->offset);
 
-		case	CLI$K_DATE:
-			{
-			struct tm _tm = {0};
+		case	CLI$K_ERR_MISSING:
+			return	snprintf(buf, bufsz, "Missing P%d - %.*s !", err->dtype, $ASC(name));
 
-			if ( 3 > (status = sscanf ($ASCPTR(val), "%2d-%2d-%4d%c%2d:%2d:%2d",
-					&_tm.tm_mday, &_tm.tm_mon, &_tm.tm_year,
-					&status,
-					&_tm.tm_hour, &_tm.tm_min, &_tm.tm_sec)) )
-				return	(clictx->opts & CLI$M_OPSIGNAL)
-					? $LOG(STS$K_ERROR, "Illformed date/time value '%.*s'",  $ASC(val))
-					: STS$K_ERROR;
-			break;
-			}
+		case	CLI$K_ERR_BADVALUE:
+			return	snprintf(buf, bufsz, "Illegal value '%.*s' of the %s '%.*s' - %s is expected, argument #%d, offset %d, errno=%d",
+				$ASC(&err->text), what, $ASC(name), cli$val_type(((CLI_PQDESC *) err->desc)->type),
+				err->tokidx, err->offset, err->errnum);
 
-		case	CLI$K_DEVICE:
-			{
-			struct stat st = {0};
+		case	CLI$K_ERR_NOMEM:
+			return	snprintf(buf, bufsz, "Insufficient memory, errno=%d", err->errnum);
 
-			if ( !(cp = strstr($ASCPTR(val), "dev/")) )
-				sprintf(cp  = buf, "/dev/%.*s", $ASC(val));
-			else	cp = $ASCPTR(val);
+		case	CLI$K_ERR_MAXARGC:
+			return	snprintf(buf, bufsz, "Too many arguments (%d > %d)", clictx->argc, cli$limits.maxargc);
 
-			if ( stat(cp, &st) )
-				return	(clictx->opts & CLI$M_OPSIGNAL)
-					? $LOG(STS$K_ERROR, "stat(%s), errno=%d", cp, errno)
-					: STS$K_ERROR;
-			break;
-			}
+		case	CLI$K_ERR_MAXBYTES:
+			return	snprintf(buf, bufsz, "Command line is too long (> %d octets), argument #%d", cli$limits.maxbytes, err->tokidx);
 
-		case	CLI$K_UUID:
-			{
-			if ( 6 != (status = sscanf ($ASCPTR(val), "%08x-%04x-%04x-%04x-%012x",
-						   &status, &status, &status, &status, &status, &status, &status, &status)) )
-				return	(clictx->opts & CLI$M_OPSIGNAL)
-					? $LOG(STS$K_ERROR, "Illformat UUID value '%.*s'", $ASC(val))
-					: STS$K_ERROR;
+		case	CLI$K_ERR_PLUGIN:
+			return	snprintf(buf, bufsz, "Cannot bind verb '%.*s', %.*s", $ASC(name), $ASC(&err->text));
 
-			break;
-			}
+		case	CLI$K_ERR_TIMEOUT:
+			return	snprintf(buf, bufsz, "Command '%.*s' has exceeded its deadline", $ASC(name));
 
-		default:
-			return	(clictx->opts & CLI$M_OPSIGNAL)
-				? $LOG(STS$K_ERROR, "Unknown  type of value '%.*s'", $ASC(val))
-				: STS$K_ERROR;
+		case	CLI$K_ERR_CANCELLED:
+			return	snprintf(buf, bufsz, "Command '%.*s' has been cancelled", $ASC(name));
 
+		case	CLI$K_ERR_OUTPUT:
+			return	snprintf(buf, bufsz, "Cannot write output, errno=%d", err->errnum);
 
+		case	CLI$K_ERR_MEMLIMIT:
+			return	snprintf(buf, bufsz, "Memory limit has been exceeded (%llu octets in context, %llu octets total)",
+				clictx->mstat.bytes, __atomic_load_n(&cli$gmstat.bytes, __ATOMIC_RELAXED));
 		}
 
-
-	return	STS$K_SUCCESS;
+	return	snprintf(buf, bufsz, "Unknown error, reason=%d, status=%d", err->reason, err->sts);
 }
 
-static	int	cli$add_item2ctx	(
-		CLI_CTX		*clictx,
-		int		type,
-		void		*item,
-		char		*val
+/*
+ *
+ *  DESCRIPTION: fill the error record of the CLI-context, a position is taken from the current argument
+ *		of the context. No formatting is performed unless CLI$M_OPSIGNAL is set.
+ *		The record of the abandoned context is owned by the dispatcher, see _cli$error().
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	sts:	condition status to be returned
+ *	reason:	CLI$K_ERR_*
+ *	dtype:	0 - verb, P1 - P8, QUAL, KWD
+ *	desc:	an offending descriptor
+ *	alt:	a second matched descriptor for ambiguous input
+ *	text:	an offending text
+ *	len:	a length of the text
+ *	errnum:	errno or 0
+ *
+ *  RETURN:
+ *	sts
+ *
+ */
+static	int	_cli$error_rec	(
+		CLI_CTX	*clictx,
+		int	sts,
+		int	reason,
+	unsigned	dtype,
+		void	*desc,
+		void	*alt,
+		char	*text,
+		int	len,
+		int	errnum
 			)
 {
-CLI_ITEM	*avp, *avp2;
-
-	/* Allocate memory for new CLI's param/qual value entry */
-	if ( !(avp = calloc(1, sizeof(CLI_ITEM))) )
-		{
-		return	(clictx->opts & CLI$M_OPSIGNAL)
-			? $LOG(STS$K_ERROR, "Insufficient memory, errno=%d", errno)
-			: STS$K_ERROR;
-		}
-
-	/* Store a given item: parameter or qualifier into the context */
-	if ( val )
-		__util$str2asc (val, &avp->val);
+CLI_ERR	*err = &clictx->err;
+char	buf[512];
+int	i;
 
-	if ( !type )
-		{
-		avp->verb = item;
+	err->sts = sts;
+	err->reason = reason;
+	err->dtype = dtype;
+	err->desc = desc;
+	err->alt = alt;
+	err->errnum = errnum;
+	err->tokidx = clictx->tokidx;
 
-		/* Run over list down to last item */
-		for ( avp2 = clictx->vlist; avp2 && avp2->next; avp2 = avp2->next);
+	for ( i = 0, err->offset = clictx->tokoff; clictx->argv && (i < clictx->tokidx) && (i < clictx->argc); i++ )
+		err->offset += strlen(clictx->argv[i]) + 1;
 
-		/* Insert new item into the CLI context list */
-		if ( avp2 )
-			avp2->next = avp;
-		else	clictx->vlist = avp;
+	if ( (err->text.len = text ? $MIN(len, ASC$K_SZ) : 0) )
+		memcpy(err->text.sts, text, err->text.len);
 
-		return	STS$K_SUCCESS;
+	if ( clictx->opts & CLI$M_OPSIGNAL )
+		{
+		cli$format_error(clictx, buf, sizeof(buf));
+		$LOG(sts, "%s", buf);
 		}
 
-	if ( CLI$K_QUAL == type )
-		avp->pqdesc = item;
-	else	avp->pqdesc =  item;
-
-	/* Run over list down to last item */
-	for ( avp2 = clictx->avlist; avp2 && avp2->next; avp2 = avp2->next);
-
-	/* Insert new item into the CLI context list */
-	if ( avp2 )
-		avp2->next = avp;
-	else	clictx->avlist = avp;
-
-	return	STS$K_SUCCESS;
+	return	sts;
 }
 
-void	cli$show_verbs	(
-	CLI_VERB	*verbs,
-		int	level
-		)
+/*
+ * An action routine abandoned by cli$dispatch_timed() can still fail, the caller is reading
+ * the record at the same time: writers are counted, the dispatcher marks the context as abandoned,
+ * waits for writers in progress and fills the record; later writes of the routine are dropped.
+ */
+static	int	_cli$error	(
+		CLI_CTX	*clictx,
+		int	sts,
+		int	reason,
+	unsigned	dtype,
+		void	*desc,
+		void	*alt,
+		char	*text,
+		int	len,
+		int	errnum
+			)
 {
-CLI_VERB *verb, *subverb;
-CLI_PQDESC *par;
-CLI_KEYWORD *kwd;
-CLI_PQDESC *qual;
-char	spaces [64];
-
-	memset(spaces, ' ', sizeof(spaces));
+	__atomic_add_fetch(&clictx->errbusy, 1, __ATOMIC_SEQ_CST);
 
-	for ( verb = verbs; $ASCLEN(&verb->name); verb++)
-		{
-		if ( !level )
-			$LOG(STS$K_INFO, "Show verb '%.*s' : ", $ASC(&verb->name));
-		else	$LOG(STS$K_INFO, " %.*s%.*s", level * 2, spaces, $ASC(&verb->name));
+	if ( __atomic_load_n(&clictx->cancel, __ATOMIC_SEQ_CST) != CLI$K_CANCEL_ABANDON )
+		_cli$error_rec(clictx, sts, reason, dtype, desc, alt, text, len, errnum);
 
-		/* Run over command's verbs list ... */
-		for ( subverb = verb->next; subverb; subverb = subverb->next)
-			cli$show_verbs(verb->next, ++level);
+	__atomic_sub_fetch(&clictx->errbusy, 1, __ATOMIC_RELEASE);
 
-		for ( par = verb->params; par && par->pn; par++)
-			{
-			$LOG(STS$K_INFO, "   P%d - '%.*s' (%s)", par->pn, $ASC(&par->name), cli$val_type (par->type));
+	return	sts;
+}
 
-			if ( par->kwd )
-				{
-				for ( kwd = par->kwd; $ASCLEN(&kwd->name); kwd++)
-					$LOG(STS$K_INFO, "      %.*s=%#x ", $ASC(&kwd->name), kwd->val);
-				}
-			}
+/*
+ *
+ *  DESCRIPTION: reserve memory in the context and global accounting, check against limits.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	sz:	a size to be reserved
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$mem_reserve	(
+		CLI_CTX	*clictx,
+		size_t	sz
+			)
+{
+unsigned long long	ctxmem, globmem, bytes, peak;
 
+	ctxmem = __atomic_load_n(&cli$limits.ctxmem, __ATOMIC_RELAXED);
+	globmem = __atomic_load_n(&cli$limits.globmem, __ATOMIC_RELAXED);
 
-		for ( qual = verb->quals; qual && $ASCLEN(&qual->name); qual++)
-			{
-			$LOG(STS$K_INFO, "   /%.*s (%s)", $ASC(&qual->name), cli$val_type (qual->type) );
+	if ( ctxmem && (clictx->mstat.bytes + sz > ctxmem) )
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_MEMLIMIT, 0, NULL, NULL, NULL, 0, ENOMEM);
 
-			if ( qual->kwd )
-				{
-				for ( kwd = qual->kwd; $ASCLEN(&kwd->name); kwd++)
-					$LOG(STS$K_INFO, "      %.*s=%#x ", $ASC(&kwd->name), kwd->val);
-				}
-			}
+	bytes = __atomic_add_fetch(&cli$gmstat.bytes, sz, __ATOMIC_RELAXED);
 
+	if ( globmem && (bytes > globmem) )
+		{
+		__atomic_sub_fetch(&cli$gmstat.bytes, sz, __ATOMIC_RELAXED);
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_MEMLIMIT, 0, NULL, NULL, NULL, 0, ENOMEM);
 		}
-}
-
-
-void	cli$show_ctx	(
-		CLI_CTX	*	clictx
-		)
-{
-CLI_ITEM	*avp;
-char	spaces [64];
-int	splen = 0;
 
-	memset(spaces, ' ', sizeof(spaces));
+	__atomic_add_fetch(&cli$gmstat.nalloc, 1, __ATOMIC_RELAXED);
 
-	$LOG(STS$K_INFO, "CLI-parser context area");
+	for ( peak = __atomic_load_n(&cli$gmstat.peak, __ATOMIC_RELAXED); peak < bytes; )
+		if ( __atomic_compare_exchange_n(&cli$gmstat.peak, &peak, bytes, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED) )
+			break;
 
+	clictx->mstat.bytes += sz;
+	clictx->mstat.nalloc++;
+	clictx->mstat.peak = $MAX(clictx->mstat.peak, clictx->mstat.bytes);
 
-	/* Run over command's verbs list ... */
-	for ( splen = 2, avp = clictx->vlist; avp; avp = avp->next, splen += 2)
-		$LOG(STS$K_INFO, "%.*s %.*s  ('%.*s')", splen, spaces, $ASC(&avp->verb->name), $ASC(&avp->val));
+	return	STS$K_SUCCESS;
+}
 
-	for ( avp = clictx->avlist; avp; avp = avp->next)
-		{
-		if ( avp->type )
-			$LOG(STS$K_INFO, "   P%d[0:%d]='%.*s'", avp->pqdesc->pn, $ASCLEN(&avp->val), $ASC(&avp->val));
-		else	$LOG(STS$K_INFO, "   /%.*s[0:%d]='%.*s'", $ASC(&avp->pqdesc->name), $ASCLEN(&avp->val), $ASC(&avp->val));
-		}
+static	void	_cli$mem_release	(
+		CLI_CTX	*clictx,
+		size_t	sz
+			)
+{
+	clictx->mstat.bytes -= sz;
+	__atomic_sub_fetch(&cli$gmstat.bytes, sz, __ATOMIC_RELAXED);
 }
 
 /*
  *
- *  DESCRIPTION: check a given string against a table of keywords,
- *	detect ambiguous input:
- *		ST	- is conflicted with START & STOP
- *	allow not full length-comparing:
- *		SH	- is matched to  SHOW
+ *  DESCRIPTION: allocate zeroed memory on behalf of the context.
  *
  *  INPUT:
- *	sts:	a keyword string to be checked
- *	opts:	processing options, see CLI$M_OP*
- *	klist:	an address of the keyword table, null entry terminated
- *
- *  OUTPUT:
- *	kwd:	an address to accept a pointer to keyword's record
+ *	clictx:	A CLI-context
+ *	sz:	a size of block
  *
  *  RETURN:
- *	SS$_NORMAL, condition status
+ *	an address of the block, NULL - limit has been exceeded or insufficient memory (STS$K_ERROR), see clictx->err
  *
  */
-static	int	cli$check_keyword	(
-			char	*sts,
-			int	 len,
-		int		opts,
-		CLI_KEYWORD	*klist,
-		CLI_KEYWORD **	kwd
-		)
+static	void	*_cli$alloc	(
+		CLI_CTX	*clictx,
+		size_t	sz
+			)
 {
-CLI_KEYWORD	*krun, *ksel;
-int	qlog = opts & CLI$M_OPTRACE;
+void	*ptr;
 
-	*kwd = NULL;
+	if ( !(1 & _cli$mem_reserve(clictx, sz)) )
+		return	NULL;
 
-	for ( krun = klist; $ASCLEN(&krun->name); krun++)
+	if ( !(ptr = calloc(1, sz)) )
 		{
-		if ( len > $ASCLEN(&krun->name) )
-			continue;
-
-		$IFTRACE(qlog, "Match [0:%d]='%.*s' against '%.*s'", len, len, sts, $ASC(&krun->name) );
-
-		if ( !strncasecmp(sts, $ASCPTR(&krun->name), $MIN(len, $ASCLEN(&krun->name))) )
-			{
-			if ( ksel )
-				{
-				return	(opts & CLI$M_OPSIGNAL)
-					? $LOG(STS$K_FATAL, "Ambiguous input '%.*s' (matched to : '%.*s', '%.*s')", len, sts, $ASC(&krun->name), $ASC(&ksel->name))
-					: STS$K_FATAL;
-				}
-
-			/* Safe has been matched keyword's record */
-			ksel = krun;
-			}
+		_cli$mem_release(clictx, sz);
+		_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_NOMEM, 0, NULL, NULL, NULL, 0, errno);
 		}
 
-	if ( ksel )
-		{
-		*kwd = ksel;
-		return	STS$K_SUCCESS;
-		}
+	return	ptr;
+}
 
-	return	(opts & CLI$M_OPSIGNAL)
-		? $LOG(STS$K_ERROR, "Illegal or unrecognized keyword '%.*s'", len, sts)
-		: STS$K_ERROR;
+static	void	_cli$free	(
+		CLI_CTX	*clictx,
+		void	*ptr,
+		size_t	sz
+			)
+{
+	free(ptr);
+	_cli$mem_release(clictx, sz);
 }
 
 /*
  *
- *  DESCRIPTION: extract a params list from the command line corresponding to definition
- *		of the param list from the 'verb'
+ *  DESCRIPTION: retrieve memory accounting of the context or all contexts.
  *
  *  INPUT:
- *	verbs:	verb's definition structure
- *	opts:	processing options, see CLI$M_OP*
- *	argc:	arguments count
- *	argv:	arguments array
+ *	clictx:	A CLI-context, NULL - global accounting
  *
- *  IMPLICIT OUTPUT:
- *	ctx:	A CLI-context to be created
+ *  OUTPUT:
+ *	mstat:	a buffer to accept counters
  *
  *  RETURN:
  *	SS$_NORMAL, condition status
  *
  */
-static	int	_cli$parse_quals(
-	CLI_CTX	*	clictx,
-	CLI_VERB	*verb,
-		int	argc,
-		char ** argv
+int	cli$get_memstat	(
+		CLI_CTX	*clictx,
+		CLI_MSTAT *mstat
 			)
 {
-CLI_PQDESC	*qrun, *qsel = NULL;
-int		status, len, i, qlog = clictx->opts & CLI$M_OPTRACE;
-char		*aptr, *vptr;
-
-	/*
-	 *  Run over arguments from command line
-	 */
-	for ( qsel = NULL, aptr = argv[i = 0]; argc; argc--, i++,  aptr = argv[i] )
+	if ( clictx )
 		{
-		if ( (*aptr == '-') || (*aptr == '/') )
-			aptr++;
-		else	continue;
+		*mstat = clictx->mstat;
+		return	STS$K_SUCCESS;
+		}
 
-		/* Is there '=' and value ? */
-		if ( vptr = strchr(aptr, '=') )
-			len = vptr - aptr;
-		else	len = strnlen(aptr, ASC$K_SZ);
+	mstat->bytes = __atomic_load_n(&cli$gmstat.bytes, __ATOMIC_RELAXED);
+	mstat->items = __atomic_load_n(&cli$gmstat.items, __ATOMIC_RELAXED);
+	mstat->peak = __atomic_load_n(&cli$gmstat.peak, __ATOMIC_RELAXED);
+	mstat->nalloc = __atomic_load_n(&cli$gmstat.nalloc, __ATOMIC_RELAXED);
 
-		for ( qsel = NULL, qrun = verb->quals; $ASCLEN(&qrun->name); qrun++  )
-			{
-			if ( len > $ASCLEN(&qrun->name) )
-				continue;
+	return	STS$K_SUCCESS;
+}
 
-//			$IFTRACE(qlog, "Match [0:%d]='%.*s' against '%.*s'", len, len, aptr, $ASC(&qrun->name) );
+/*
+ * Context pool: contexts are laid out in a single block, every context is followed by preallocated
+ * items. Free contexts are linked by indexes, the head of the freelist is tagged (tag:32, index:32)
+ * against ABA. A thread takes/returns contexts from/to its cache, the freelist is touched by batches.
+ * Live pools are registered, so a cache bound to other pool is flushed only to a pool still alive.
+ * Allocation and release run in a reader's section of the pools' grace period, so cli$ctx_pool_free()
+ * can wait for threads are still working with the pool has been detached.
+ */
+#define	CLI$K_POOLNIL	0xffffffffU
 
-			if ( !strncasecmp(aptr, $ASCPTR(&qrun->name), len) )
-				{
-				if ( qsel )
-					{
-					return	(clictx->opts & CLI$M_OPSIGNAL)
-						? $LOG(STS$K_FATAL, "Ambiguous input '%.*s' (matched to : '%.*s', '%.*s')", len, aptr, $ASC(&qrun->name), $ASC(&qsel->name))
-						: STS$K_FATAL;
-					}
+struct __cli_ctxpool__
+{
+	unsigned long long head __attribute__ ((aligned(64)));	/* Tagged freelist's head	*/
 
-				vptr	+= (vptr != NULL);
-				$IFTRACE(qlog, "%.*s='%s'", $ASC(&qrun->name), vptr);
+	unsigned long long id;		/* A unique id of the pool		*/
+	int		nctxs,
+			nitems;
+	size_t		stride;		/* A size of the context with items	*/
+	char		*base;
+	unsigned	*next;		/* Freelist's links			*/
 
-				status = cli$add_item2ctx(clictx, CLI$K_QUAL, qrun, vptr);
+	CLI_POOLSTAT	stat;
 
-				qsel = qrun;
-				}
-			}
+	struct __cli_ctxpool__ *link;	/* Live pools list, see cli$pool_lock	*/
+};
+
+typedef struct __cli_poolcache__
+{
+	CLI_CTXPOOL	*pool;
+	unsigned long long id;		/* Pool's id, 0 - cache isn't bound	*/
+	int		n;
+	unsigned	idx [CLI$K_POOLCACHE];
+} CLI_POOLCACHE;
+
+static	CLI_CTXPOOL	*cli$ctx_poolp;		/* Attached pool, see cli$ctx_pool()	*/
+static	CLI_CTXPOOL	*cli$pools;		/* Live pools				*/
+static	pthread_mutex_t	cli$pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static	unsigned long long cli$pool_seq;
+static	__thread CLI_POOLCACHE cli$pool_cache;
+static	pthread_key_t	cli$pool_key;
+static	pthread_once_t	cli$pool_once = PTHREAD_ONCE_INIT;
+static	unsigned	cli$pool_epoch;		/* Grace period's counter		*/
+static	int		cli$pool_readers[2];	/* Threads in the even/odd epoch	*/
+static	pthread_mutex_t	cli$pool_synclock = PTHREAD_MUTEX_INITIALIZER;	/* Serialize grace periods */
+
+/* Enter a reader's section, return a slot for _cli$pool_leave() */
+static	int	_cli$pool_enter	(void)
+{
+unsigned	epoch;
+
+	for ( ;; )
+		{
+		epoch = __atomic_load_n(&cli$pool_epoch, __ATOMIC_SEQ_CST);
+		__atomic_add_fetch(&cli$pool_readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+
+		if ( epoch == __atomic_load_n(&cli$pool_epoch, __ATOMIC_SEQ_CST) )
+			return	epoch & 1;
+
+		__atomic_sub_fetch(&cli$pool_readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
 		}
+}
 
-	return	STS$K_SUCCESS;
+static	void	_cli$pool_leave	(
+		int	slot
+			)
+{
+	__atomic_sub_fetch(&cli$pool_readers[slot], 1, __ATOMIC_SEQ_CST);
 }
 
-/*
- *
- *  DESCRIPTION: extract a params list from the command line corresponding to definition
- *		of the param list from the 'verb, add param/value pair into the 'CLI-context' area.
+/* Wait until all readers have been entered before the call leave the section */
+static	void	_cli$pool_sync	(void)
+{
+unsigned	epoch;
+
+	pthread_mutex_lock(&cli$pool_synclock);
+
+	epoch = __atomic_load_n(&cli$pool_epoch, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&cli$pool_epoch, epoch + 1, __ATOMIC_SEQ_CST);
+
+	while ( __atomic_load_n(&cli$pool_readers[epoch & 1], __ATOMIC_SEQ_CST) )
+		sched_yield();
+
+	pthread_mutex_unlock(&cli$pool_synclock);
+}
+
+static	int	_cli$pool_pop	(
+		CLI_CTXPOOL *pool,
+		unsigned *idx
+			)
+{
+unsigned long long head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE), nhead;
+
+	do	{
+		if ( (unsigned) head == CLI$K_POOLNIL )
+			return	0;
+
+		nhead = (((head >> 32) + 1) << 32) | __atomic_load_n(&pool->next[(unsigned) head], __ATOMIC_RELAXED);
+		} while ( !__atomic_compare_exchange_n(&pool->head, &head, nhead, 1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE) );
+
+	*idx = (unsigned) head;
+
+	return	1;
+}
+
+static	void	_cli$pool_push	(
+		CLI_CTXPOOL *pool,
+		unsigned idx
+			)
+{
+unsigned long long head = __atomic_load_n(&pool->head, __ATOMIC_RELAXED), nhead;
+
+	do	{
+		__atomic_store_n(&pool->next[idx], (unsigned) head, __ATOMIC_RELAXED);
+		nhead = (((head >> 32) + 1) << 32) | idx;
+		} while ( !__atomic_compare_exchange_n(&pool->head, &head, nhead, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED) );
+}
+
+/* Return cached contexts to the pool they have been taken from, unless the pool has been released */
+static	void	_cli$pool_flush	(
+		CLI_POOLCACHE	*cache
+			)
+{
+CLI_CTXPOOL	*pool;
+
+	if ( cache->n )
+		{
+		pthread_mutex_lock(&cli$pool_lock);
+
+		for ( pool = cli$pools; pool && ((pool != cache->pool) || (pool->id != cache->id)); pool = pool->link);
+
+		if ( pool )
+			while ( cache->n )
+				_cli$pool_push(pool, cache->idx[--cache->n]);
+
+		pthread_mutex_unlock(&cli$pool_lock);
+		}
+
+	cache->n = 0;
+}
+
+/* Return contexts of the exiting thread's cache */
+static	void	_cli$pool_exit	(
+		void	*arg
+			)
+{
+CLI_POOLCACHE	*cache = arg;
+
+	_cli$pool_flush(cache);
+	cache->id = 0;
+}
+
+static	void	_cli$pool_key	(void)
+{
+	pthread_key_create(&cli$pool_key, _cli$pool_exit);
+}
+
+/* Bind the thread's cache to the pool, contexts of other pool are returned to it */
+static	CLI_POOLCACHE	*_cli$pool_cache	(
+		CLI_CTXPOOL *pool
+			)
+{
+CLI_POOLCACHE	*cache = &cli$pool_cache;
+
+	if ( cache->id == pool->id )
+		return	cache;
+
+	if ( !cache->id )
+		{
+		pthread_once(&cli$pool_once, _cli$pool_key);
+		pthread_setspecific(cli$pool_key, cache);
+		}
+	else	_cli$pool_flush(cache);
+
+	cache->pool = pool;
+	cache->id = pool->id;
+
+	return	cache;
+}
+
+/*
  *
- *  INPUT:
- *	clictx:	A CLI-context to be created
- *	opts:	processing options, see CLI$M_OP*
- *	argc:	arguments count
- *	argv:	arguments array
+ *  DESCRIPTION: allocate a zeroed CLI-context from the attached pool or from the heap.
  *
  *  RETURN:
- *	SS$_NORMAL, condition status
+ *	an address of the context, NULL - insufficient memory
  *
  */
-static	int	_cli$parse_params(
-	CLI_CTX	*	clictx,
-	CLI_VERB	*verb,
-		int	argc,
-		char ** argv
+static	CLI_CTX	*_cli$ctx_alloc	(void)
+{
+CLI_CTXPOOL	*pool;
+CLI_POOLCACHE	*cache;
+CLI_CTX		*ctx;
+unsigned	idx;
+int		slot = _cli$pool_enter();
+
+	if ( !(pool = __atomic_load_n(&cli$ctx_poolp, __ATOMIC_ACQUIRE)) )
+		{
+		_cli$pool_leave(slot);
+		return	calloc(1, sizeof(CLI_CTX));
+		}
+
+	cache = _cli$pool_cache(pool);
+
+	/* Refill a half of the cache from the freelist */
+	if ( !cache->n )
+		{
+		while ( (cache->n < CLI$K_POOLCACHE / 2) && _cli$pool_pop(pool, &idx) )
+			cache->idx[cache->n++] = idx;
+
+		__atomic_add_fetch(cache->n ? &pool->stat.refills : &pool->stat.misses, 1, __ATOMIC_RELAXED);
+
+		if ( !cache->n )
+			{
+			_cli$pool_leave(slot);
+			return	calloc(1, sizeof(CLI_CTX));
+			}
+		}
+
+	ctx = (CLI_CTX *) (pool->base + cache->idx[--cache->n] * pool->stride);
+
+	memset(ctx, 0, sizeof(CLI_CTX));
+	__atomic_store_n(&ctx->pool, pool, __ATOMIC_SEQ_CST);	/* In use, see cli$ctx_pool_free() */
+	ctx->items = (CLI_ITEM *) (ctx + 1);
+	ctx->maxitems = pool->nitems;
+
+	_cli$pool_leave(slot);
+
+	return	ctx;
+}
+
+static	void	_cli$ctx_free	(
+		CLI_CTX	*clictx
 			)
 {
-CLI_PQDESC	*param;
-int		status, pi, qlog = clictx->opts & CLI$M_OPTRACE;
+CLI_CTXPOOL	*pool = clictx->pool;
+CLI_POOLCACHE	*cache;
+unsigned	idx;
+int		slot;
 
-	/*
-	 * Run firstly over parameters list and extract values
-	 */
-	for ( pi = 0, param = verb->params; param && (pi < argc) && param->pn; param++, pi++ )
+	if ( !pool )
 		{
-		$IFTRACE(qlog, "P%d(%.*s)='%s'", param->pn, $ASC(&param->name), argv[pi] );
+		free(clictx);
+		return;
+		}
 
-		/* Put parameter's value into the CLI context */
-		if ( !(1 & (status = cli$add_item2ctx (clictx, param->pn, param, argv[pi]))) )
-			return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "Error inserting P%d - %.*s into CLI context area", param->pn, $ASC(&param->name)) : STS$K_FATAL;
+	/* The pool is alive while the context is in use, keep it alive up to the end */
+	slot = _cli$pool_enter();
+
+	idx = ((char *) clictx - pool->base) / pool->stride;
+	__atomic_store_n(&clictx->pool, NULL, __ATOMIC_SEQ_CST);
+	cache = _cli$pool_cache(pool);
+
+	/* Flush a half of the full cache to the freelist */
+	if ( cache->n == CLI$K_POOLCACHE )
+		{
+		while ( cache->n > CLI$K_POOLCACHE / 2 )
+			_cli$pool_push(pool, cache->idx[--cache->n]);
+
+		__atomic_add_fetch(&pool->stat.flushes, 1, __ATOMIC_RELAXED);
 		}
 
-	/* Did we get all parameters ? */
-	if ( param && param->pn )
-		return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "Missing P%d - %.*s !", param->pn, $ASC(&param->name)) : STS$K_FATAL;
+	cache->idx[cache->n++] = idx;
 
-	/* Now we can extract qualifiers ... */
-	status = _cli$parse_quals(clictx, verb, argc - pi, argv + pi);
+	_cli$pool_leave(slot);
+}
 
-	return	status;
+/* Items are taken from the pooled context's array first */
+static	CLI_ITEM *_cli$item_alloc	(
+		CLI_CTX	*clictx
+			)
+{
+CLI_ITEM	*avp;
+
+	if ( clictx->nitems >= clictx->maxitems )
+		return	_cli$alloc(clictx, sizeof(CLI_ITEM));
+
+	if ( !(1 & _cli$mem_reserve(clictx, sizeof(CLI_ITEM))) )
+		return	NULL;
+
+	avp = &clictx->items[clictx->nitems++];
+	memset(avp, 0, offsetof(CLI_ITEM, val));
+	avp->val.len = 0;
+
+	return	avp;
+}
+
+static	void	_cli$item_free	(
+		CLI_CTX	*clictx,
+		CLI_ITEM *avp
+			)
+{
+	if ( (avp >= clictx->items) && (avp < clictx->items + clictx->maxitems) )
+		_cli$mem_release(clictx, sizeof(CLI_ITEM));
+	else	_cli$free(clictx, avp, sizeof(CLI_ITEM));
 }
 
 /*
  *
- *  DESCRIPTION: parsing input list of arguments by using a command's verbs definition is provided by 'verbs'
- *		syntax definition. Internaly performs command verb matching and calling other CLI-routines to parse 'parameters'
- *		and 'qualifiers'.
- *		Create a CLI-context area is supposed to be used by cli$get_value() routine to extract a parameter value.
-
+ *  DESCRIPTION: create a pool of CLI-contexts, every context has preallocated items.
+ *
  *  INPUT:
- *	verbs:	commands' verbs definition structure, null entry terminated
- *	opts:	processing options, see CLI$M_OP*
- *	argc:	arguments count
- *	argv:	arguments array
+ *	nctxs:	a number of contexts
+ *	nitems:	a number of items per context
  *
  *  OUTPUT:
- *	ctx:	A CLI-context to be created
+ *	pool:	a pool's handle
  *
  *  RETURN:
  *	SS$_NORMAL, condition status
  *
  */
-static	int	_cli$parse_verb	(
-	CLI_CTX		*clictx,
-	CLI_VERB *	verbs,
-		int	argc,
-		char ** argv
+int	cli$ctx_pool_init	(
+	CLI_CTXPOOL	**pool,
+		int	nctxs,
+		int	nitems
 			)
 {
-CLI_VERB	*vrun, *vsel;
-int		status, len, qlog = clictx->opts & CLI$M_OPTRACE;
-char		*pverb;
+CLI_CTXPOOL	*pp;
+unsigned	i;
 
-	$IFTRACE(qlog, "argc=%d", argc);
+	if ( (nctxs <= 0) || (nitems < 0) )
+		return	$LOG(STS$K_ERROR, "Illegal pool's size, contexts=%d, items=%d", nctxs, nitems);
 
-	/*
-	 * Sanity check for input arguments ...
-	 */
-	if ( argc < 1 )
-		return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "Too many arguments") : STS$K_FATAL;
+	if ( !(*pool = pp = calloc(1, sizeof(CLI_CTXPOOL))) )
+		return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
 
+	pp->nctxs = nctxs;
+	pp->nitems = nitems;
+	pp->stride = (sizeof(CLI_CTX) + nitems * sizeof(CLI_ITEM) + 63) & (~63);
+	pp->id = __atomic_add_fetch(&cli$pool_seq, 1, __ATOMIC_RELAXED);
+	pp->stat.ctxs = nctxs;
 
-	pverb = argv[0];
+	if ( posix_memalign((void **) &pp->base, 64, nctxs * pp->stride) || !(pp->next = malloc(nctxs * sizeof(unsigned))) )
+		{
+		free(pp->base);
+		free(pp);
+		*pool = NULL;
+		return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+		}
 
-	/*
-	 * First at all we need to match  argv[1] in the verbs list
-	 */
-	len = strnlen(pverb, CLI$S_MAXVERBL);
+	/* Touch all pages now, so the first commands don't fault */
+	memset(pp->base, 0, nctxs * pp->stride);
 
-	$IFTRACE(qlog, "argv[1]='%s'->[0:%d]='%.*s'", pverb, len, len, pverb);
+	for ( i = 0; i < (unsigned) nctxs; i++)
+		pp->next[i] = (i + 1 < (unsigned) nctxs) ? i + 1 : CLI$K_POOLNIL;
 
-	for (vrun = verbs, vsel = NULL; $ASCLEN(&vrun->name); vrun++)
-		{
-		if ( len > $ASCLEN(&vrun->name) )
-			continue;
+	pp->head = 0;
 
-		$IFTRACE(qlog, "Matching '%.*s' vs '%.*s' ... ", len, pverb, $ASC(&vrun->name));
+	pthread_mutex_lock(&cli$pool_lock);
+	pp->link = cli$pools;
+	cli$pools = pp;
+	pthread_mutex_unlock(&cli$pool_lock);
 
-		/*
-		 * Match verb from command line against given verbs table,
-		 * we are comparing at minimal length, but we must checks for ambiguous verb's definitions like:
-		 *
-		 * SET will match verbs: SET & SETUP
-		 * DEL will match: DELETE & DELIVERY
-		 *
-		 */
-		if ( !strncasecmp(pverb, $ASCPTR(&vrun->name), $MIN(len, $ASCLEN(&vrun->name))) )
-			{
-			$IFTRACE(qlog, "Matched on length=%d '%.*s' := '%.*s' !", $MIN(len, $ASCLEN(&vrun->name)), len, pverb, $ASC(&vrun->name));
+	return	STS$K_SUCCESS;
+}
 
-			/* Check that there is not previous matches */
-			if ( vsel )
-				{
-				return	(clictx->opts & CLI$M_OPSIGNAL)
-					? $LOG(STS$K_FATAL, "Ambiguous input '%.*s' (matched to : '%.*s', '%.*s')", len, pverb, $ASC(&vrun->name), $ASC(&vsel->name))
-					: STS$K_FATAL;
-				}
+/*
+ *
+ *  DESCRIPTION: attach the pool, cli$parse() takes contexts from it.
+ *
+ *  INPUT:
+ *	pool:	a pool's handle, NULL - contexts are allocated from the heap
+ *
+ *  RETURN:
+ *	SS$_NORMAL
+ *
+ */
+int	cli$ctx_pool	(
+	CLI_CTXPOOL	*pool
+			)
+{
+	__atomic_store_n(&cli$ctx_poolp, pool, __ATOMIC_RELEASE);
 
-			/* Safe matched verb for future checks */
-			vsel = vrun;
-			}
-		}
+	return	STS$K_SUCCESS;
+}
 
-	/* Found something ?*/
-	if ( !vsel )
-		return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "Unrecognized command verb '%.*s'", len, pverb) : STS$K_FATAL;
+int	cli$ctx_pool_stat	(
+	CLI_CTXPOOL	*pool,
+	CLI_POOLSTAT	*stat
+			)
+{
+	stat->ctxs = pool->stat.ctxs;
+	stat->refills = __atomic_load_n(&pool->stat.refills, __ATOMIC_RELAXED);
+	stat->flushes = __atomic_load_n(&pool->stat.flushes, __ATOMIC_RELAXED);
+	stat->misses = __atomic_load_n(&pool->stat.misses, __ATOMIC_RELAXED);
 
-	/*
-	 * Ok, we has got in 'vsel' a legal verb, so
-	 * so we will now matching arguments from 'argv' against
-	 * the verb's parameters and qualifiers list
-	 */
-	/* Insert new item into the CLI context list */
-	cli$add_item2ctx (clictx, 0, vsel, pverb);
+	return	STS$K_SUCCESS;
+}
 
-	/* Is there a next subverb ? */
-	if ( vsel->next )
-		status = _cli$parse_verb	(clictx, vsel, argc - 1, argv++);
-	else	{
-		if ( ( !vsel->params) && (!vsel->quals) )
-			return	STS$K_SUCCESS;
+/*
+ *
+ *  DESCRIPTION: release the pool, the pool is detached if it's attached. Contexts cached by threads
+ *		are forgotten, contexts are still in use (not released by cli$cleanup()) make the call fail,
+ *		the pool is attached back in this case. The call can be issued while other threads are
+ *		parsing: it waits for allocations and releases in progress.
+ *
+ *  INPUT:
+ *	pool:	a pool's handle
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$ctx_pool_free	(
+	CLI_CTXPOOL	*pool
+			)
+{
+CLI_CTXPOOL	*cur = pool, **pprev;
+int		i, busy, attached;
 
-		status = _cli$parse_params(clictx, vsel, argc - 1, argv + 1);
+	/* Detach the pool if it's still attached, wait for allocations have been seen it */
+	attached = __atomic_compare_exchange_n(&cli$ctx_poolp, &cur, NULL, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	_cli$pool_sync();
+
+	for ( busy = i = 0; i < pool->nctxs; i++)
+		busy += (NULL != __atomic_load_n(&((CLI_CTX *) (pool->base + i * pool->stride))->pool, __ATOMIC_SEQ_CST));
+
+	if ( busy )
+		{
+		cur = NULL;
+
+		if ( attached )
+			__atomic_compare_exchange_n(&cli$ctx_poolp, &cur, pool, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+
+		return	$LOG(STS$K_ERROR, "Pool cannot be released, %d contexts are in use", busy);
 		}
 
-	return	status;
-}
+	/* Wait for releases have been seen the last contexts in use */
+	_cli$pool_sync();
+
+	pthread_mutex_lock(&cli$pool_lock);
+
+	for ( pprev = &cli$pools; *pprev && (*pprev != pool); pprev = &(*pprev)->link);
+
+	if ( *pprev )
+		*pprev = pool->link;
+
+	pthread_mutex_unlock(&cli$pool_lock);
+
+	if ( cli$pool_cache.id == pool->id )
+		cli$pool_cache.id = cli$pool_cache.n = 0;
 
+	free(pool->next);
+	free(pool->base);
+	free(pool);
+
+	return	STS$K_SUCCESS;
+}
 
 /*
  *
- *  DESCRIPTION: a top level routine - as main entry for the CLI parsing.
- *		Create a CLI-context area is supposed to be used by cli$get_value() routine to extract a parameter value.
+ *  DESCRIPTION: Check a input value for the parameter/qualifier corresponding has been declared type
 
- *  INPUT:
- *	verbs:	commands' verbs definition structure, null entry terminated
- *	opts:	processing options, see CLI$M_OP*
- *	argc:	arguments count
- *	argv:	arguments array
  *
- *  OUTPUT:
- *	ctx:	A CLI-context to be created
+ *  INPUT:
+ *	clictx:	CLI-context has been created by cli$parse()
+ *	pqdesc:	Parameter/Qualifier descriptor
+ *	val:	an ASCIC string to be checked
  *
  *  RETURN:
  *	SS$_NORMAL, condition status
  *
  */
-int	cli$parse	(
-	CLI_VERB *	verbs,
-	int		opts,
-		int	argc,
-		char ** argv,
-		void **	clictx
+static	int	cli$val_check	(
+		CLI_CTX		*clictx,
+		CLI_PQDESC	*pqdesc,
+			ASC	*val
+				)
+{
+unsigned long long int	status = -1;
+char	buf[ASC$K_SZ + 6], *cp;	/* "/dev/" + value */
+unsigned dtype = pqdesc->pn ? pqdesc->pn : CLI$K_QUAL;
+struct in6_addr	addr;
+
+	/* A value of the maximum length can be not NUL terminated, work on a copy */
+	snprintf(buf, sizeof(buf), "%.*s", $ASC(val));
+
+	switch (pqdesc->type)
+		{
+		case	CLI$K_IPV4:
+		case	CLI$K_IPV6:
+			if ( 1 !=  inet_pton(pqdesc->type == CLI$K_IPV4 ? AF_INET : AF_INET6, buf, &addr) )
+				return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, dtype, pqdesc, NULL, $ASCPTR(val), $ASCLEN(val), errno);
+			break;
+
+		case	CLI$K_NUM:
+			errno = 0;
+			strtoull(buf, &cp, 0);
+
+			if ( (errno == ERANGE) || (cp == buf) || *cp )
+				return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, dtype, pqdesc, NULL, $ASCPTR(val), $ASCLEN(val), errno);
+
+			break;
+
+		case	CLI$K_DATE:
+			{
+			struct tm _tm = {0};
+
+			if ( 3 > (status = sscanf (buf, "%2d-%2d-%4d%c%2d:%2d:%2d",
+					&_tm.tm_mday, &_tm.tm_mon, &_tm.tm_year,
+					&status,
+					&_tm.tm_hour, &_tm.tm_min, &_tm.tm_sec)) )
+				return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, dtype, pqdesc, NULL, $ASCPTR(val), $ASCLEN(val), 0);
+			break;
+			}
+
+		case	CLI$K_DEVICE:
+			{
+			struct stat st = {0};
+
+			/* A wildcard is matched by action routine */
+			if ( strpbrk(buf, "*?[") )
+				break;
+
+			if ( !strstr(buf, "dev/") )
+				snprintf(buf, sizeof(buf), "/dev/%.*s", $ASC(val));
+
+			if ( stat(buf, &st) )
+				return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, dtype, pqdesc, NULL, $ASCPTR(val), $ASCLEN(val), errno);
+			break;
+			}
+
+		case	CLI$K_UUID:
+			{
+			unsigned	f[4];
+			unsigned long long node;
+
+			if ( 5 != sscanf (buf, "%8x-%4x-%4x-%4x-%12llx", &f[0], &f[1], &f[2], &f[3], &node) )
+				return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, dtype, pqdesc, NULL, $ASCPTR(val), $ASCLEN(val), 0);
+
+			break;
+			}
+
+		case	CLI$K_KWD:
+			{
+			CLI_KEYWORD *kwd;
+
+			if ( !pqdesc->kwd )
+				break;
+
+			return	cli$check_keyword(clictx, $ASCPTR(val), $ASCLEN(val), pqdesc->kwd, &kwd);
+			}
+
+		case	CLI$K_FILE:
+		case	CLI$K_QSTRING:
+		case	CLI$K_OPT:
+			break;
+
+		default:
+			return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, dtype, pqdesc, NULL, $ASCPTR(val), $ASCLEN(val), 0);
+
+
+		}
+
+
+	return	STS$K_SUCCESS;
+}
+
+static	int	cli$add_item2ctx	(
+		CLI_CTX		*clictx,
+		int		type,
+		void		*item,
+		char		*val
+			)
+{
+CLI_ITEM	*avp;
+
+	/* Allocate memory for new CLI's param/qual value entry */
+	if ( !(avp = _cli$item_alloc(clictx)) )
+		return	STS$K_ERROR;
+
+	clictx->mstat.items++;
+	__atomic_add_fetch(&cli$gmstat.items, 1, __ATOMIC_RELAXED);
+
+	/* Store a given item: parameter or qualifier into the context */
+	if ( val )
+		__util$str2asc (val, &avp->val);
+
+	avp->type = type;
+	avp->tokidx = clictx->tokidx;
+	avp->tokoff = clictx->tokoff;
+
+	if ( !type )
+		{
+		avp->verb = item;
+
+		/* Insert new item at tail of the CLI context list */
+		if ( clictx->vtail )
+			clictx->vtail->next = avp;
+		else	clictx->vlist = avp;
+
+		clictx->vtail = avp;
+
+		return	STS$K_SUCCESS;
+		}
+
+	avp->pqdesc = item;
+
+	/* Insert new item at tail of the CLI context list */
+	if ( clictx->avtail )
+		clictx->avtail->next = avp;
+	else	clictx->avlist = avp;
+
+	clictx->avtail = avp;
+
+	/* Check a value against declared type of the parameter/qualifier, list's elements are checked at iteration */
+	if ( $ASCLEN(&avp->val) && !(avp->pqdesc->flag & CLI$M_LIST) && !(clictx->opts & CLI$M_OPDEFERVAL) )
+		return	cli$val_check(clictx, avp->pqdesc, &avp->val);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: check values of the parameters/qualifiers has been parsed with the CLI$M_OPDEFERVAL,
+ *		a position of the offending value is restored from the item.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context has been created by cli$parse()
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$validate	(
+		CLI_CTX	*clictx
+			)
+{
+CLI_ITEM	*avp;
+int		status;
+
+	for ( avp = clictx->avlist; avp; avp = avp->next)
+		{
+		if ( !$ASCLEN(&avp->val) || (avp->pqdesc->flag & CLI$M_LIST) )
+			continue;
+
+		clictx->tokidx = avp->tokidx;
+		clictx->tokoff = avp->tokoff;
+
+		if ( !(1 & (status = cli$val_check(clictx, avp->pqdesc, &avp->val))) )
+			return	status;
+		}
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ * A growable output buffer for help/schema rendering
+ */
+typedef struct __cli_buf__
+{
+	char	*ptr;
+	int	len,
+		size,
+		sts;		/* STS$K_ERROR - allocation failed	*/
+} CLI_BUF;
+
+typedef	struct __cli_helpent__
+{
+	CLI_VERB	*verbs;
+	unsigned	version,
+			gen;		/* cli$verbs_gen at rendering	*/
+	int		fmt,
+			len;
+	unsigned long long tick;
+	char		*text;
+} CLI_HELPENT;
+
+static	pthread_mutex_t	cli$help_lock = PTHREAD_MUTEX_INITIALIZER;
+static	CLI_HELPENT	cli$help_cache [CLI$S_HELPCACHE];
+static	unsigned long long cli$help_tick;
+
+__attribute__((format(printf, 2, 3)))
+static	void	_cli$buf_put	(
+		CLI_BUF	*buf,
+	const	char	*fmt,
+			...
+			)
+{
+va_list	ap;
+int	len, size;
+char	*ptr;
+
+	if ( buf->sts == STS$K_ERROR )
+		return;
+
+	for ( ;; )
+		{
+		va_start(ap, fmt);
+		len = vsnprintf(buf->ptr + buf->len, buf->size - buf->len, fmt, ap);
+		va_end(ap);
+
+		if ( len < buf->size - buf->len )
+			break;
+
+		size = $MAX(buf->size * 2, buf->len + len + 1);
+		size = $MAX(size, 4096);
+
+		if ( !(ptr = realloc(buf->ptr, size)) )
+			{
+			buf->sts = STS$K_ERROR;
+			return;
+			}
+
+		buf->ptr = ptr;
+		buf->size = size;
+		}
+
+	buf->len += len;
+}
+
+/* Append raw data, the buffer is marked as failed if it would exceed 'limit' */
+static	void	_cli$buf_add	(
+		CLI_BUF	*buf,
+	const	char	*ptr,
+		int	len,
+		int	limit
+			)
+{
+int	size;
+char	*np;
+
+	if ( buf->sts == STS$K_ERROR )
+		return;
+
+	if ( buf->len + len > limit )
+		{
+		buf->sts = STS$K_ERROR;
+		return;
+		}
+
+	if ( buf->len + len > buf->size )
+		{
+		size = $MIN(limit, $MAX(buf->size * 2, $MAX(buf->len + len, 4096)));
+
+		if ( !(np = realloc(buf->ptr, size)) )
+			{
+			buf->sts = STS$K_ERROR;
+			return;
+			}
+
+		buf->ptr = np;
+		buf->size = size;
+		}
+
+	memcpy(buf->ptr + buf->len, ptr, len);
+	buf->len += len;
+}
+
+/* Put a JSON string, escape special characters */
+static	void	_cli$buf_jstr	(
+		CLI_BUF	*buf,
+		int	len,
+	const	char	*sts
+			)
+{
+int	i;
+
+	_cli$buf_put(buf, "\"");
+
+	for ( i = 0; i < len; i++ )
+		{
+		if ( (sts[i] == '"') || (sts[i] == '\\') )
+			_cli$buf_put(buf, "\\%c", sts[i]);
+		else if ( (unsigned char) sts[i] < 0x20 )
+			_cli$buf_put(buf, "\\u%04x", (unsigned char) sts[i]);
+		else	_cli$buf_put(buf, "%c", sts[i]);
+		}
+
+	_cli$buf_put(buf, "\"");
+}
+
+static	const char *_cli$val_tname	(
+			int	valtype
+			)
+{
+	switch (valtype)
+		{
+		case	CLI$K_FILE:	return	"FILE";
+		case	CLI$K_DATE:	return	"DATE";
+		case	CLI$K_NUM:	return	"NUM";
+		case	CLI$K_IPV4:	return	"IPV4";
+		case	CLI$K_IPV6:	return	"IPV6";
+		case	CLI$K_OPT:	return	"OPT";
+		case	CLI$K_QSTRING:	return	"QSTRING";
+		case	CLI$K_UUID:	return	"UUID";
+		case	CLI$K_DEVICE:	return	"DEVICE";
+		case	CLI$K_KWD:	return	"KWD";
+		}
+
+	return	"ILLEGAL";
+}
+
+static	void	_cli$render_kwds_text	(
+		CLI_BUF		*buf,
+		CLI_KEYWORD	*kwd,
+		int		level
+			)
+{
+	for ( ; kwd && $ASCLEN(&kwd->name); kwd++)
+		_cli$buf_put(buf, "%*s      %.*s=%#llx\n", level * 2, "", $ASC(&kwd->name), kwd->val);
+}
+
+static	void	_cli$render_text	(
+		CLI_BUF		*buf,
+		CLI_VERB	*verbs,
+		int		level
+			)
+{
+CLI_VERB *verb, *vb;
+CLI_PQDESC *pq;
+
+	for ( verb = verbs; verb && $ASCLEN(&verb->name); verb++)
+		{
+		_cli$buf_put(buf, "%*s%.*s\n", level * 2, "", $ASC(&verb->name));
+
+		/* Don't load shared object just to show it */
+		if ( !(vb = verb->shlib ? _cli$plugin_find(verb) : verb) )
+			{
+			_cli$buf_put(buf, "%*s   (not loaded, '%s')\n", level * 2, "", verb->shlib);
+			continue;
+			}
+
+		for ( pq = vb->params; pq && pq->pn; pq++)
+			{
+			_cli$buf_put(buf, "%*s   P%d - '%.*s' (%s)\n", level * 2, "", pq->pn, $ASC(&pq->name), cli$val_type (pq->type));
+			_cli$render_kwds_text(buf, pq->kwd, level);
+			}
+
+		for ( pq = vb->quals; pq && $ASCLEN(&pq->name); pq++)
+			{
+			_cli$buf_put(buf, "%*s   /%.*s (%s)\n", level * 2, "", $ASC(&pq->name), cli$val_type (pq->type));
+			_cli$render_kwds_text(buf, pq->kwd, level);
+			}
+
+		/* Subverbs are walked once, one level deeper */
+		if ( vb->next )
+			_cli$render_text(buf, vb->next, level + 1);
+		}
+}
+
+static	void	_cli$render_pq_json	(
+		CLI_BUF		*buf,
+		CLI_PQDESC	*pq,
+		int		qual
+			)
+{
+CLI_KEYWORD *kwd;
+int	first;
+
+	_cli$buf_put(buf, "{\"name\":");
+	_cli$buf_jstr(buf, $ASC(&pq->name));
+
+	if ( !qual )
+		_cli$buf_put(buf, ",\"pn\":%d", pq->pn);
+
+	_cli$buf_put(buf, ",\"type\":\"%s\",\"list\":%s", _cli$val_tname(pq->type), (pq->flag & CLI$M_LIST) ? "true" : "false");
+
+	if ( pq->kwd )
+		{
+		_cli$buf_put(buf, ",\"keywords\":[");
+
+		for ( first = 1, kwd = pq->kwd; $ASCLEN(&kwd->name); kwd++, first = 0)
+			{
+			_cli$buf_put(buf, "%s{\"name\":", first ? "" : ",");
+			_cli$buf_jstr(buf, $ASC(&kwd->name));
+			_cli$buf_put(buf, ",\"value\":%llu}", kwd->val);
+			}
+
+		_cli$buf_put(buf, "]");
+		}
+
+	_cli$buf_put(buf, "}");
+}
+
+static	void	_cli$render_json	(
+		CLI_BUF		*buf,
+		CLI_VERB	*verbs
+			)
+{
+CLI_VERB *verb, *vb;
+CLI_PQDESC *pq;
+int	first;
+
+	_cli$buf_put(buf, "[");
+
+	for ( verb = verbs; verb && $ASCLEN(&verb->name); verb++)
+		{
+		_cli$buf_put(buf, "%s{\"name\":", (verb == verbs) ? "" : ",");
+		_cli$buf_jstr(buf, $ASC(&verb->name));
+
+		if ( !(vb = verb->shlib ? _cli$plugin_find(verb) : verb) )
+			{
+			_cli$buf_put(buf, ",\"plugin\":");
+			_cli$buf_jstr(buf, strlen(verb->shlib), verb->shlib);
+			_cli$buf_put(buf, ",\"loaded\":false}");
+			continue;
+			}
+
+		_cli$buf_put(buf, ",\"params\":[");
+		for ( first = 1, pq = vb->params; pq && pq->pn; pq++, first = 0)
+			{
+			_cli$buf_put(buf, first ? "" : ",");
+			_cli$render_pq_json(buf, pq, 0);
+			}
+
+		_cli$buf_put(buf, "],\"quals\":[");
+		for ( first = 1, pq = vb->quals; pq && $ASCLEN(&pq->name); pq++, first = 0)
+			{
+			_cli$buf_put(buf, first ? "" : ",");
+			_cli$render_pq_json(buf, pq, 1);
+			}
+
+		_cli$buf_put(buf, "],\"verbs\":");
+
+		if ( vb->next )
+			_cli$render_json(buf, vb->next);
+		else	_cli$buf_put(buf, "[]");
+
+		_cli$buf_put(buf, "}");
+		}
+
+	_cli$buf_put(buf, "]");
+}
+
+/*
+ *
+ *  DESCRIPTION: render a help text or JSON schema of the verbs tree, a result is cached
+ *	by the (verbs, version, fmt), repeated requests are served by copying of the cached text.
+ *	Binding of stubs and updates of CLI_TABLE's invalidate the whole cache by themselves,
+ *	so a reused address of a released array is never served from the cache.
+ *
+ *  INPUT:
+ *	verbs:	a verbs table, null entry terminated
+ *	version:a version of the table, must be changed on any table's modification
+ *	fmt:	CLI$K_FMT_TEXT or CLI$K_FMT_JSON
+ *	buf:	a buffer to accept rendered text, NULL - just compute length
+ *	bufsz:	a size of the buffer
+ *
+ *  OUTPUT:
+ *	retlen:	a length of the rendered text (without trailing zero)
+ *
+ *  RETURN:
+ *	SS$_NORMAL, STS$K_WARN - buffer is too small, *retlen is the required length, condition status
+ *
+ */
+int	cli$render_help	(
+		CLI_VERB	*verbs,
+		unsigned	version,
+			int	fmt,
+			char	*buf,
+			int	bufsz,
+			int	*retlen
+			)
+{
+CLI_HELPENT	*ent, *lru;
+CLI_BUF		out = {0};
+int		status = STS$K_SUCCESS;
+unsigned	gen;
+
+	pthread_mutex_lock(&cli$help_lock);
+
+	/* Taken before rendering: a concurrent change makes the entry stale, never a stale one valid */
+	gen = __atomic_load_n(&cli$verbs_gen, __ATOMIC_ACQUIRE);
+
+	for ( lru = ent = cli$help_cache; ent < cli$help_cache + CLI$S_HELPCACHE; ent++)
+		{
+		if ( ent->text && (ent->verbs == verbs) && (ent->version == version) && (ent->gen == gen) && (ent->fmt == fmt) )
+			break;
+
+		if ( ent->tick < lru->tick )
+			lru = ent;
+		}
+
+	/* Cache miss - render into the least recently used slot */
+	if ( ent == cli$help_cache + CLI$S_HELPCACHE )
+		{
+		if ( fmt == CLI$K_FMT_JSON )
+			_cli$render_json(&out, verbs);
+		else	_cli$render_text(&out, verbs, 0);
+
+		if ( out.sts == STS$K_ERROR )
+			{
+			pthread_mutex_unlock(&cli$help_lock);
+			free(out.ptr);
+			return	$LOG(STS$K_ERROR, "Cannot allocate memory, errno=%d", errno);
+			}
+
+		free(lru->text);
+
+		ent = lru;
+		ent->verbs = verbs;
+		ent->version = version;
+		ent->gen = gen;
+		ent->fmt = fmt;
+		ent->text = out.ptr;
+		ent->len = out.len;
+		}
+
+	ent->tick = ++cli$help_tick;
+	*retlen = ent->len;
+
+	if ( buf && (bufsz > ent->len) )
+		{
+		memcpy(buf, ent->text, ent->len);
+		buf[ent->len] = '\0';
+		}
+	else	status = STS$K_WARN;
+
+	pthread_mutex_unlock(&cli$help_lock);
+
+	return	status;
+}
+
+void	cli$show_verbs	(
+	CLI_VERB	*verbs,
+		int	level
+		)
+{
+CLI_BUF	out = {0};
+int	len, status;
+unsigned version;
+
+	/*
+	 * A whole table is served from the cache, a subtree is rendered on the fly. The table is of
+	 * unknown origin, so it's versioned by the library's generation of the verbs trees.
+	 */
+	if ( !level )
+		{
+		version = __atomic_load_n(&cli$verbs_gen, __ATOMIC_ACQUIRE);
+
+		/* A text can grow between calls if the tree has been changed, retry with a larger buffer */
+		while ( STS$K_WARN == (status = cli$render_help(verbs, version, CLI$K_FMT_TEXT, out.ptr, out.size, &len)) )
+			{
+			free(out.ptr);
+
+			if ( !(out.ptr = malloc(out.size = len + 1)) )
+				break;
+			}
+
+		if ( 1 & status )
+			out.len = len;
+		else	{
+			free(out.ptr);
+			out.ptr = NULL;
+			}
+		}
+	else	_cli$render_text(&out, verbs, level);
+
+	if ( out.ptr )
+		$LOG(STS$K_INFO, "Verbs table:\n%.*s", out.len, out.ptr);
+
+	free(out.ptr);
+}
+
+
+void	cli$show_ctx	(
+		CLI_CTX	*	clictx
+		)
+{
+CLI_ITEM	*avp;
+char	spaces [64], name[ASC$K_SZ + 8], val[ASC$K_SZ + 1];
+int	splen = 0;
+const char *hdr[] = {"ITEM", "VALUE"}, *rec[] = {name, val};
+const int widths[] = {24, 0};
+
+	/* Records are rendered by the attached output sink */
+	if ( clictx->out )
+		{
+		cli$put_header(clictx, 2, hdr, widths);
+
+		for ( avp = clictx->vlist; avp; avp = avp->next)
+			{
+			snprintf(name, sizeof(name), "%.*s", $ASC(&avp->verb->name));
+			snprintf(val, sizeof(val), "%.*s", $ASC(&avp->val));
+			cli$put_output(clictx, 2, rec);
+			}
+
+		for ( avp = clictx->avlist; avp; avp = avp->next)
+			{
+			if ( avp->type != CLI$K_QUAL )
+				snprintf(name, sizeof(name), "P%d", avp->pqdesc->pn);
+			else	snprintf(name, sizeof(name), "/%.*s", $ASC(&avp->pqdesc->name));
+
+			snprintf(val, sizeof(val), "%.*s", $ASC(&avp->val));
+			cli$put_output(clictx, 2, rec);
+			}
+
+		cli$flush_output(clictx);
+
+		return;
+		}
+
+	memset(spaces, ' ', sizeof(spaces));
+
+	$LOG(STS$K_INFO, "CLI-parser context area");
+
+
+	/* Run over command's verbs list ... */
+	for ( splen = 2, avp = clictx->vlist; avp; avp = avp->next, splen += 2)
+		$LOG(STS$K_INFO, "%.*s %.*s  ('%.*s')", splen, spaces, $ASC(&avp->verb->name), $ASC(&avp->val));
+
+	for ( avp = clictx->avlist; avp; avp = avp->next)
+		{
+		if ( avp->type != CLI$K_QUAL )
+			$LOG(STS$K_INFO, "   P%d[0:%d]='%.*s'", avp->pqdesc->pn, $ASCLEN(&avp->val), $ASC(&avp->val));
+		else	$LOG(STS$K_INFO, "   /%.*s[0:%d]='%.*s'", $ASC(&avp->pqdesc->name), $ASCLEN(&avp->val), $ASC(&avp->val));
+		}
+}
+
+/*
+ *
+ *  DESCRIPTION: check a given string against a table of keywords,
+ *	detect ambiguous input:
+ *		ST	- is conflicted with START & STOP
+ *	allow not full length-comparing:
+ *		SH	- is matched to  SHOW
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	sts:	a keyword string to be checked
+ *	len:	a length of the keyword string
+ *	klist:	an address of the keyword table, null entry terminated
+ *
+ *  OUTPUT:
+ *	kwd:	an address to accept a pointer to keyword's record
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	cli$check_keyword	(
+		CLI_CTX		*clictx,
+			char	*sts,
+			int	 len,
+		CLI_KEYWORD	*klist,
+		CLI_KEYWORD **	kwd
+		)
+{
+CLI_KEYWORD	*krun, *ksel = NULL;
+int	qlog = clictx->opts & CLI$M_OPTRACE;
+
+	*kwd = NULL;
+
+	for ( krun = klist; $ASCLEN(&krun->name); krun++)
+		{
+		if ( len > $ASCLEN(&krun->name) )
+			continue;
+
+		$IFTRACE(qlog, "Match [0:%d]='%.*s' against '%.*s'", len, len, sts, $ASC(&krun->name) );
+
+		if ( !strncasecmp(sts, $ASCPTR(&krun->name), $MIN(len, $ASCLEN(&krun->name))) )
+			{
+			if ( ksel )
+				{
+				return	_cli$error(clictx, STS$K_FATAL, CLI$K_ERR_AMBIGUOUS, CLI$K_KWD, krun, ksel, sts, len, 0);
+				}
+
+			/* Safe has been matched keyword's record */
+			ksel = krun;
+			}
+		}
+
+	if ( ksel )
+		{
+		*kwd = ksel;
+		return	STS$K_SUCCESS;
+		}
+
+	return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_UNRECOGNIZED, CLI$K_KWD, NULL, NULL, sts, len, 0);
+}
+
+/*
+ *
+ *  DESCRIPTION: match a qualifier's name against the qualifiers table of the verb,
+ *		exact match is selected wherever it is in the table, a shortened name must not be ambiguous.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	quals:	qualifiers table, null entry terminated
+ *	aptr:	a qualifier's name (without '/' or '-')
+ *	len:	a length of the name
+ *
+ *  OUTPUT:
+ *	qsel:	an address to accept a pointer to the qualifier's definition
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$match_qual	(
+	CLI_CTX	*	clictx,
+	CLI_PQDESC	*quals,
+		char	*aptr,
+		int	len,
+	CLI_PQDESC	**qsel
+			)
+{
+CLI_PQDESC	*qrun, *alt = NULL;
+
+	for ( *qsel = NULL, qrun = quals; qrun && $ASCLEN(&qrun->name); qrun++  )
+		{
+		if ( len > $ASCLEN(&qrun->name) )
+			continue;
+
+		if ( strncasecmp(aptr, $ASCPTR(&qrun->name), len) )
+			continue;
+
+		/* Exact match cannot be ambiguous, stop scanning */
+		if ( len == $ASCLEN(&qrun->name) )
+			{
+			*qsel = qrun;
+			return	STS$K_SUCCESS;
+			}
+
+		/* A second shortened match is ambiguous unless an exact match follows */
+		if ( *qsel )
+			alt = alt ? alt : qrun;
+		else	*qsel = qrun;
+		}
+
+	if ( !*qsel )
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_UNRECOGNIZED, CLI$K_QUAL, NULL, NULL, aptr, len, 0);
+
+	if ( alt )
+		return	_cli$error(clictx, STS$K_FATAL, CLI$K_ERR_AMBIGUOUS, CLI$K_QUAL, alt, *qsel, aptr, len, 0);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: extract a params list from the command line corresponding to definition
+ *		of the param list from the 'verb'
+ *
+ *  INPUT:
+ *	verbs:	verb's definition structure
+ *	opts:	processing options, see CLI$M_OP*
+ *	argc:	arguments count
+ *	argv:	arguments array
+ *
+ *  IMPLICIT OUTPUT:
+ *	ctx:	A CLI-context to be created
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$parse_quals(
+	CLI_CTX	*	clictx,
+	CLI_VERB	*verb,
+		int	argc,
+		char ** argv
+			)
+{
+CLI_PQDESC	*qsel = NULL;
+int		status, len, i, qlog = clictx->opts & CLI$M_OPTRACE;
+char		*aptr, *vptr;
+
+	/*
+	 *  Run over arguments from command line, every argument is matched against
+	 *  the qualifiers table once, so a cost is linear in the number of arguments
+	 */
+	for ( i = 0; i < argc; i++ )
+		{
+		aptr = argv[i];
+
+		if ( (*aptr == '-') || (*aptr == '/') )
+			aptr++;
+		else	continue;
+
+		clictx->tokidx = (argv + i) - clictx->argv;
+		clictx->tokoff = 1;
+
+		/* Is there '=' and value ? */
+		if ( vptr = strchr(aptr, '=') )
+			len = vptr - aptr;
+		else	len = strnlen(aptr, ASC$K_SZ);
+
+		if ( !(1 & (status = _cli$match_qual(clictx, verb->quals, aptr, len, &qsel))) )
+			return	status;
+
+		vptr	+= (vptr != NULL);
+		$IFTRACE(qlog, "%.*s='%s'", $ASC(&qsel->name), vptr);
+
+		clictx->tokoff = vptr ? vptr - argv[i] : 0;
+
+		if ( !(1 & (status = cli$add_item2ctx(clictx, CLI$K_QUAL, qsel, vptr))) )
+			return	status;
+		}
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: extract a params list from the command line corresponding to definition
+ *		of the param list from the 'verb, add param/value pair into the 'CLI-context' area.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context to be created
+ *	opts:	processing options, see CLI$M_OP*
+ *	argc:	arguments count
+ *	argv:	arguments array
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$parse_params(
+	CLI_CTX	*	clictx,
+	CLI_VERB	*verb,
+		int	argc,
+		char ** argv
+			)
+{
+CLI_PQDESC	*param;
+int		status, pi, qlog = clictx->opts & CLI$M_OPTRACE;
+
+	/*
+	 * Run firstly over parameters list and extract values
+	 */
+	for ( pi = 0, param = verb->params; param && (pi < argc) && param->pn; param++, pi++ )
+		{
+		$IFTRACE(qlog, "P%d(%.*s)='%s'", param->pn, $ASC(&param->name), argv[pi] );
+
+		clictx->tokidx = (argv + pi) - clictx->argv;
+		clictx->tokoff = 0;
+
+		/* Put parameter's value into the CLI context */
+		if ( !(1 & (status = cli$add_item2ctx (clictx, param->pn, param, argv[pi]))) )
+			return	status;
+		}
+
+	/* Did we get all parameters ? */
+	if ( param && param->pn )
+		{
+		clictx->tokidx = (argv + pi) - clictx->argv;
+		clictx->tokoff = 0;
+
+		return	_cli$error(clictx, STS$K_FATAL, CLI$K_ERR_MISSING, param->pn, param, NULL, NULL, 0, 0);
+		}
+
+	/* Now we can extract qualifiers ... */
+	status = _cli$parse_quals(clictx, verb, argc - pi, argv + pi);
+
+	return	status;
+}
+
+/*
+ * Stubs are never changed in place: the verbs array can be a shared snapshot of the CLI_TABLE
+ * is copied by writers concurrently. A bound copy of the stub is kept in the list is only grown,
+ * entries are published with release and looked up without locking.
+ */
+typedef struct __cli_plugin__ {
+	struct __cli_plugin__ *next;	/* Linked list stuff			*/
+	CLI_VERB	stub,		/* An image of the stub is a lookup key	*/
+			verb;		/* The stub is bound to the shared object*/
+} CLI_PLUGIN;
+
+static	CLI_PLUGIN	*cli$plugins;
+
+static	CLI_VERB *_cli$plugin_find	(
+	CLI_VERB	*verb
+			)
+{
+CLI_PLUGIN	*plug;
+
+	for ( plug = __atomic_load_n(&cli$plugins, __ATOMIC_ACQUIRE); plug; plug = plug->next)
+		if ( !memcmp(&plug->stub, verb, sizeof(CLI_VERB)) )
+			return	&plug->verb;
+
+	return	NULL;
+}
+
+/*
+ *
+ *  DESCRIPTION: bind a verb's stub to the shared object: load the object and make a bound copy
+ *		of the stub with a subtable, parameters, qualifiers and action routine from the CLI_VERB
+ *		record is exported by the object. The object is loaded only once and is never unloaded.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	verb:	A verb's stub to be bound
+ *
+ *  OUTPUT:
+ *	verb:	the bound copy of the stub, the verb itself if it is not a stub
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$bind_verb	(
+	CLI_CTX		*clictx,
+	CLI_VERB	**verb
+			)
+{
+void		*hdl;
+CLI_VERB	*plug, *stub = *verb;
+CLI_PLUGIN	*bound;
+char		*sym, *msg;
+int		status = STS$K_SUCCESS;
+
+	if ( !stub->shlib )
+		return	STS$K_SUCCESS;
+
+	if ( (plug = _cli$plugin_find(stub)) )
+		{
+		*verb = plug;
+		return	STS$K_SUCCESS;
+		}
+
+	sym = stub->shsym ? stub->shsym : CLI$T_PLUGSYM;
+
+	pthread_mutex_lock(&cli$plugin_lock);
+
+	/* Has been bound by other thread while we are waiting for lock ? */
+	if ( (plug = _cli$plugin_find(stub)) )
+		{
+		pthread_mutex_unlock(&cli$plugin_lock);
+		*verb = plug;
+		return	STS$K_SUCCESS;
+		}
+
+	$IFTRACE(clictx->opts & CLI$M_OPTRACE, "Loading '%.*s' from '%s'", $ASC(&stub->name), stub->shlib);
+
+	if ( !(hdl = dlopen(stub->shlib, RTLD_NOW | RTLD_LOCAL)) || !(plug = dlsym(hdl, sym)) )
+		{
+		/* A symbol can be present but be NULL, there is no error message then */
+		if ( !(msg = dlerror()) )
+			msg = "Symbol is not found";
+
+		status = _cli$error(clictx, STS$K_FATAL, CLI$K_ERR_PLUGIN, 0, stub, NULL, msg, strlen(msg), 0);
+
+		if ( hdl )
+			dlclose(hdl);
+		}
+	else if ( !(bound = calloc(1, sizeof(CLI_PLUGIN))) )
+		{
+		status = _cli$error(clictx, STS$K_FATAL, CLI$K_ERR_NOMEM, 0, stub, NULL, NULL, 0, errno);
+		dlclose(hdl);
+		}
+	else	{
+		bound->stub = *stub;
+		bound->verb = *stub;
+
+		bound->verb.next = plug->next;
+		bound->verb.params = plug->params;
+		bound->verb.quals = plug->quals;
+		bound->verb.act_rtn = plug->act_rtn;
+		bound->verb.act_arg = plug->act_arg;
+		bound->verb.flags |= plug->flags;
+		bound->verb.ttl = plug->ttl ? plug->ttl : stub->ttl;
+		bound->verb.sched = plug->sched ? plug->sched : stub->sched;
+		bound->verb.cost = plug->cost ? plug->cost : stub->cost;
+		bound->verb.bound = 1;
+
+		/* Make the bound copy visible to lookups, rendered help is stale now */
+		bound->next = cli$plugins;
+		__atomic_store_n(&cli$plugins, bound, __ATOMIC_RELEASE);
+		__atomic_add_fetch(&cli$verbs_gen, 1, __ATOMIC_RELEASE);
+
+		*verb = &bound->verb;
+		}
+
+	pthread_mutex_unlock(&cli$plugin_lock);
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: match a verb from command line against given verbs table.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	verbs:	commands' verbs definition structure, null entry terminated
+ *	pverb:	a verb's string
+ *	len:	a length of the verb's string
+ *
+ *  OUTPUT:
+ *	vsel:	an address to accept a pointer to the verb's definition
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$match_verb	(
+	CLI_CTX		*clictx,
+	CLI_VERB *	verbs,
+		char	*pverb,
+		int	len,
+	CLI_VERB **	vsel
+			)
+{
+CLI_VERB	*vrun, *alt = NULL;
+int		qlog = clictx->opts & CLI$M_OPTRACE;
+
+	for (vrun = verbs, *vsel = NULL; vrun && $ASCLEN(&vrun->name); vrun++)
+		{
+		if ( len > $ASCLEN(&vrun->name) )
+			continue;
+
+		$IFTRACE(qlog, "Matching '%.*s' vs '%.*s' ... ", len, pverb, $ASC(&vrun->name));
+
+		/*
+		 * Match verb from command line against given verbs table,
+		 * we are comparing at minimal length, but we must checks for ambiguous verb's definitions like:
+		 *
+		 * SET will match verbs: SET & SETUP
+		 * DEL will match: DELETE & DELIVERY
+		 *
+		 * an exact match is selected immediately.
+		 */
+		if ( !strncasecmp(pverb, $ASCPTR(&vrun->name), $MIN(len, $ASCLEN(&vrun->name))) )
+			{
+			$IFTRACE(qlog, "Matched on length=%d '%.*s' := '%.*s' !", $MIN(len, $ASCLEN(&vrun->name)), len, pverb, $ASC(&vrun->name));
+
+			if ( len == $ASCLEN(&vrun->name) )
+				{
+				*vsel = vrun;
+				return	STS$K_SUCCESS;
+				}
+
+			/* Check that there is not previous matches, an exact match can follow yet */
+			if ( *vsel )
+				alt = alt ? alt : vrun;
+			else	*vsel = vrun;	/* Safe matched verb for future checks */
+			}
+		}
+
+	if ( alt )
+		return	_cli$error(clictx, STS$K_FATAL, CLI$K_ERR_AMBIGUOUS, 0, alt, *vsel, pverb, len, 0);
+
+	/* Found something ?*/
+	if ( !*vsel )
+		return	_cli$error(clictx, STS$K_FATAL, CLI$K_ERR_UNRECOGNIZED, 0, NULL, NULL, pverb, len, 0);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: parsing input list of arguments by using a command's verbs definition is provided by 'verbs'
+ *		syntax definition. Internaly performs command verb matching and calling other CLI-routines to parse 'parameters'
+ *		and 'qualifiers'.
+ *		Create a CLI-context area is supposed to be used by cli$get_value() routine to extract a parameter value.
+
+ *  INPUT:
+ *	verbs:	commands' verbs definition structure, null entry terminated
+ *	opts:	processing options, see CLI$M_OP*
+ *	argc:	arguments count
+ *	argv:	arguments array
+ *
+ *  OUTPUT:
+ *	ctx:	A CLI-context to be created
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$parse_verb	(
+	CLI_CTX		*clictx,
+	CLI_VERB *	verbs,
+		int	argc,
+		char ** argv
+			)
+{
+CLI_VERB	*vsel;
+int		status, len, qlog = clictx->opts & CLI$M_OPTRACE;
+char		*pverb;
+
+	$IFTRACE(qlog, "argc=%d", argc);
+
+	clictx->tokidx = argv - clictx->argv;
+	clictx->tokoff = 0;
+
+	/*
+	 * Sanity check for input arguments ...
+	 */
+	if ( argc < 1 )
+		return	_cli$error(clictx, STS$K_FATAL, CLI$K_ERR_NOVERB, 0, NULL, NULL, NULL, 0, 0);
+
+
+	pverb = argv[0];
+
+	/*
+	 * First at all we need to match  argv[1] in the verbs list
+	 */
+	len = strnlen(pverb, CLI$S_MAXVERBL);
+
+	$IFTRACE(qlog, "argv[1]='%s'->[0:%d]='%.*s'", pverb, len, len, pverb);
+
+	if ( !(1 & (status = _cli$match_verb(clictx, verbs, pverb, len, &vsel))) )
+		return	status;
+
+	/* Is it a stub of the verb ? Load and bind it at first use */
+	if ( !(1 & (status = _cli$bind_verb(clictx, &vsel))) )
+		return	status;
+
+	/*
+	 * Ok, we has got in 'vsel' a legal verb, so
+	 * so we will now matching arguments from 'argv' against
+	 * the verb's parameters and qualifiers list
+	 */
+	/* Insert new item into the CLI context list */
+	if ( !(1 & (status = cli$add_item2ctx (clictx, 0, vsel, pverb))) )
+		return	status;
+
+	/* Is there a next subverb ? */
+	if ( vsel->next )
+		status = _cli$parse_verb	(clictx, vsel->next, argc - 1, argv + 1);
+	else	{
+		if ( ( !vsel->params) && (!vsel->quals) )
+			return	STS$K_SUCCESS;
+
+		status = _cli$parse_params(clictx, vsel, argc - 1, argv + 1);
+		}
+
+	return	status;
+}
+
+
+/*
+ *
+ *  DESCRIPTION: check arguments list against limits has been set by cli$set_limits(), a length of
+ *		every argument is computed up to rest of the bytes limit.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	argc:	arguments count
+ *	argv:	arguments array
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$check_limits	(
+		CLI_CTX	*clictx,
+		int	argc,
+		char **	argv
+			)
+{
+int	maxargc, maxbytes, i;
+size_t	bytes;
+unsigned long long ctxmem, globmem, est;
+
+	maxargc = __atomic_load_n(&cli$limits.maxargc, __ATOMIC_RELAXED);
+	maxbytes = __atomic_load_n(&cli$limits.maxbytes, __ATOMIC_RELAXED);
+
+	clictx->tokidx = clictx->tokoff = 0;
+
+	if ( maxargc && (argc > maxargc) )
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_MAXARGC, 0, NULL, NULL, NULL, 0, 0);
+
+	/* Every argument is stored at most in one item, so reject early if it cannot fit in the limits */
+	ctxmem = __atomic_load_n(&cli$limits.ctxmem, __ATOMIC_RELAXED);
+	globmem = __atomic_load_n(&cli$limits.globmem, __ATOMIC_RELAXED);
+	est = (unsigned long long) argc * sizeof(CLI_ITEM);
+
+	if ( (ctxmem && (clictx->mstat.bytes + est > ctxmem))
+		|| (globmem && (__atomic_load_n(&cli$gmstat.bytes, __ATOMIC_RELAXED) + est > globmem)) )
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_MEMLIMIT, 0, NULL, NULL, NULL, 0, ENOMEM);
+
+	if ( !maxbytes )
+		return	STS$K_SUCCESS;
+
+	for ( i = 0, bytes = 0; i < argc; i++ )
+		{
+		bytes += strnlen(argv[i], maxbytes - bytes + 1);
+
+		if ( bytes > (size_t) maxbytes )
+			{
+			clictx->tokidx = i;
+			return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_MAXBYTES, 0, NULL, NULL, NULL, 0, 0);
+			}
+		}
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: set limits are applied to input of the cli$parse(), zero value - no limit.
+ *
+ *  INPUT:
+ *	limits:	new limits
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$set_limits	(
+		CLI_LIMITS	*limits
+			)
+{
+	if ( (limits->maxargc < 0) || (limits->maxbytes < 0) )
+		return	$LOG(STS$K_ERROR, "Illegal limits (maxargc=%d, maxbytes=%d)", limits->maxargc, limits->maxbytes);
+
+	__atomic_store_n(&cli$limits.maxargc, limits->maxargc, __ATOMIC_RELAXED);
+	__atomic_store_n(&cli$limits.maxbytes, limits->maxbytes, __ATOMIC_RELAXED);
+	__atomic_store_n(&cli$limits.ctxmem, limits->ctxmem, __ATOMIC_RELAXED);
+	__atomic_store_n(&cli$limits.globmem, limits->globmem, __ATOMIC_RELAXED);
+	__atomic_store_n(&cli$limits.dsptmo, limits->dsptmo, __ATOMIC_RELAXED);
+
+	return	STS$K_SUCCESS;
+}
+
+int	cli$get_limits	(
+		CLI_LIMITS	*limits
+			)
+{
+	limits->maxargc = __atomic_load_n(&cli$limits.maxargc, __ATOMIC_RELAXED);
+	limits->maxbytes = __atomic_load_n(&cli$limits.maxbytes, __ATOMIC_RELAXED);
+	limits->ctxmem = __atomic_load_n(&cli$limits.ctxmem, __ATOMIC_RELAXED);
+	limits->globmem = __atomic_load_n(&cli$limits.globmem, __ATOMIC_RELAXED);
+	limits->dsptmo = __atomic_load_n(&cli$limits.dsptmo, __ATOMIC_RELAXED);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: a top level routine - as main entry for the CLI parsing.
+ *		Create a CLI-context area is supposed to be used by cli$get_value() routine to extract a parameter value.
+
+ *  INPUT:
+ *	verbs:	commands' verbs definition structure, null entry terminated
+ *	opts:	processing options, see CLI$M_OP*
+ *	argc:	arguments count
+ *	argv:	arguments array
+ *
+ *  OUTPUT:
+ *	ctx:	A CLI-context to be created, on parsing failure the context is created too and keeps
+ *		an error record (see CLI_ERR, cli$format_error()), it must be released by cli$cleanup()
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$parse	(
+	CLI_VERB *	verbs,
+	int		opts,
+		int	argc,
+		char ** argv,
+		void **	clictx
+			)
+{
+int	status, qlog = opts & CLI$M_OPTRACE;
+CLI_CTX	*ctx, chk = {.opts = opts, .argc = argc, .argv = argv, .mstat = {.bytes = sizeof(CLI_CTX)}};
+unsigned long long t0 = 0;
+
+	$IFTRACE(qlog, "argc=%d, opts=%#x", argc, opts);
+
+	if ( 0 <= __atomic_load_n(&cli$rec_fd, __ATOMIC_RELAXED) )
+		t0 = _cli$now(CLOCK_MONOTONIC);
+
+	/*
+	 * Sanity check for input arguments: an empty command line is rejected the same way as oversized one,
+	 * before any allocation, a context to be created is accounted too
+	 */
+	if ( argc < 1 )
+		status = _cli$error(&chk, STS$K_FATAL, CLI$K_ERR_NOVERB, 0, NULL, NULL, NULL, 0, 0);
+	else	status = _cli$check_limits(&chk, argc, argv);
+
+	/* Create CLI-context area: from the attached pool or the heap */
+	if ( !(*clictx = _cli$ctx_alloc()) )
+		return	(opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno) : STS$K_FATAL;
+	ctx = *clictx;
+	ctx->opts = opts;
+	ctx->argc = argc;
+	ctx->argv = argv;
+
+	/* The context of rejected input only carries the error record, nothing is accounted against it */
+	if ( !(1 & status) )
+		{
+		ctx->err = chk.err;
+		return	status;
+		}
+
+	/* Account the context itself */
+	if ( !(1 & (status = _cli$mem_reserve(ctx, sizeof(CLI_CTX)))) )
+		return	status;
+
+
+	status = _cli$parse_verb(*clictx, verbs, argc, argv);
+
+	if ( t0 )
+		_cli$rec_parse(ctx, argc, argv, status, t0);
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: retreive a value of the parameter or qualifier from the CLI-context has been created and filled by cli$parse().
+
+ *  INPUT:
+ *	ctx:	A CLI-context has been created by cli$parse()
+ *	pq:	A pointer to parameter/qualifier definition
+ *	val:	A buffer to accept value
+ *
+ *  RETURN:
+ *	STS$K_WARN	- value is zero length
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$get_value	(
+	CLI_CTX		*clictx,
+	CLI_PQDESC	*pq,
+		ASC	*val
+			)
+{
+CLI_ITEM *item;
+
+	/* Sanity check */
+	if ( !clictx )
+		return	$LOG(STS$K_FATAL, "CLI-context is empty");
+
+	if ( !pq )
+		return	$LOG(STS$K_FATAL, "Illegal parameter/qualifier definition");
+
+	for ( item = clictx->avlist; item; item = item->next)
+		{
+		if ( pq  == item->pqdesc )
+			{
+			/* Do we need to return a qualifier value to caller ?*/
+			if ( val )
+				{
+				*val = item->val;
+
+				if ( !($ASCLEN(val)) )
+					return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_WARN, "Zero length value") : STS$K_WARN;
+				}
+
+			return	STS$K_SUCCESS;
+			}
+
+		}
+
+	return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_ERROR, "No parameter/qualifier ('%.*s') is present in command line",
+						       $ASC(&pq->name)) : STS$K_ERROR;
+}
+
+
+/*
+ * List-valued parameters stuff
+ */
+#define	CLI$S_LISTBUF	(64 * 1024)	/* A read buffer for stdin and pipes	*/
+
+struct __cli_list__ {
+	CLI_CTX		*clictx;
+	CLI_PQDESC	*pqdesc;
+
+	int		fd,	/* A stream to be read, -1 - mapped or inline	*/
+			mapped,	/* 'base' is a mapped response file		*/
+			eof;	/* End of stream has been reached		*/
+
+	char		*base;	/* Elements text				*/
+	size_t		size,	/* A length of the text				*/
+			pos;	/* A current position in the text		*/
+
+	int		count;	/* Elements have been returned			*/
+	ASC		inl;	/* Inline list					*/
+};
+
+/*
+ *
+ *  DESCRIPTION: read a next portion of the stream into the buffer, unprocessed rest is moved to begin.
+ *
+ *  INPUT:
+ *	list:	A list's iterator
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$list_fill	(
+		CLI_LIST	*list
+			)
+{
+ssize_t	rc;
+
+	if ( list->pos )
+		{
+		memmove(list->base, list->base + list->pos, list->size - list->pos);
+		list->size -= list->pos;
+		list->pos = 0;
+		}
+
+	for ( ; list->size < CLI$S_LISTBUF; )
+		{
+		if ( 0 > (rc = read(list->fd, list->base + list->size, CLI$S_LISTBUF - list->size)) )
+			{
+			if ( errno == EINTR )
+				continue;
+
+			return	_cli$error(list->clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, list->pqdesc->pn ? list->pqdesc->pn : CLI$K_QUAL,
+				list->pqdesc, NULL, NULL, 0, errno);
+			}
+
+		if ( !rc )
+			{
+			list->eof = 1;
+			break;
+			}
+
+		list->size += rc;
+
+		/* Is there at least one complete element ? */
+		if ( memchr(list->base, '\n', list->size) )
+			break;
+		}
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: open an iterator over the list-valued parameter or qualifier. Value forms are:
+ *		"a,b,c"	- inline list, can be enclosed in parentheses: "(a,b,c)";
+ *		"@file"	- a response file, elements are separated by new lines or commas,
+ *			  text from '!' to end of line is a comment;
+ *		"@-"	- the same as above, but elements are read from stdin.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context has been created by cli$parse()
+ *	pq:	A pointer to parameter/qualifier definition
+ *
+ *  OUTPUT:
+ *	list:	A list's iterator
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$list_open	(
+	CLI_CTX		*clictx,
+	CLI_PQDESC	*pq,
+	CLI_LIST	**list
+			)
+{
+CLI_LIST	*lp;
+struct stat	st;
+char		fspec[ASC$K_SZ];
+int		status;
+
+	if ( !(1 & (status = cli$get_value(clictx, pq, NULL))) )
+		return	status;
+
+	if ( !(lp = _cli$alloc(clictx, sizeof(CLI_LIST))) )
+		return	STS$K_ERROR;
+
+	lp->clictx = clictx;
+	lp->pqdesc = pq;
+	lp->fd = -1;
+
+	cli$get_value(clictx, pq, &lp->inl);
+
+	/* Inline list ? */
+	if ( $ASCPTR(&lp->inl)[0] != '@' )
+		{
+		if ( ($ASCLEN(&lp->inl) > 1) && ($ASCPTR(&lp->inl)[$ASCLEN(&lp->inl) - 1] == ')') && ($ASCPTR(&lp->inl)[0] == '(') )
+			{
+			$ASCLEN(&lp->inl) -= 2;
+			memmove($ASCPTR(&lp->inl), $ASCPTR(&lp->inl) + 1, $ASCLEN(&lp->inl));
+			}
+
+		lp->base = $ASCPTR(&lp->inl);
+		lp->size = $ASCLEN(&lp->inl);
+		*list = lp;
+
+		return	STS$K_SUCCESS;
+		}
+
+	/* A value can be not NUL terminated */
+	snprintf(fspec, sizeof(fspec), "%.*s", $ASCLEN(&lp->inl) - 1, $ASCPTR(&lp->inl) + 1);
+
+	if ( !*fspec || !strcmp(fspec, "-") )
+		lp->fd = dup(STDIN_FILENO);
+	else	lp->fd = open(fspec, O_RDONLY);
+
+	if ( (0 > lp->fd) || fstat(lp->fd, &st) )
+		{
+		status = _cli$error(clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, pq->pn ? pq->pn : CLI$K_QUAL, pq, NULL, $ASCPTR(&lp->inl), $ASCLEN(&lp->inl), errno);
+		cli$list_close(lp);
+
+		return	status;
+		}
+
+	/* Regular files are mapped, other are read by chunks */
+	if ( S_ISREG(st.st_mode) )
+		{
+		if ( st.st_size && (MAP_FAILED == (lp->base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, lp->fd, 0))) )
+			{
+			lp->base = NULL;
+			status = _cli$error(clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, pq->pn ? pq->pn : CLI$K_QUAL, pq, NULL, $ASCPTR(&lp->inl), $ASCLEN(&lp->inl), errno);
+			cli$list_close(lp);
+
+			return	status;
+			}
+
+		if ( st.st_size )
+			{
+			madvise(lp->base, st.st_size, MADV_SEQUENTIAL);
+			lp->mapped = 1;
+			lp->size = st.st_size;
+			}
+
+		close(lp->fd);
+		lp->fd = -1;
+		}
+	else if ( !(lp->base = _cli$alloc(clictx, CLI$S_LISTBUF)) )
+		{
+		status = STS$K_ERROR;
+		cli$list_close(lp);
+
+		return	status;
+		}
+
+	*list = lp;
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: return a next element of the list, the element is checked against declared type
+ *		of the parameter or qualifier.
+ *
+ *  INPUT:
+ *	list:	A list's iterator has been created by cli$list_open()
+ *
+ *  OUTPUT:
+ *	val:	A buffer to accept the element
+ *
+ *  RETURN:
+ *	SS$_NORMAL	- a legal element has been returned
+ *	STS$K_WARN	- no more elements
+ *	condition status, element is returned in the 'val', iteration can be continued
+ *
+ */
+int	cli$list_next	(
+	CLI_LIST	*list,
+		ASC	*val
+			)
+{
+CLI_CTX	*clictx = list->clictx;
+char	*cp, *ep, **argv;
+size_t	len;
+int	status;
+
+	for ( ;; )
+		{
+		/* Skip separators and comments */
+		for ( ; list->pos < list->size; list->pos++ )
+			{
+			cp = list->base + list->pos;
+
+			if ( *cp == '!' )
+				{
+				if ( !(ep = memchr(cp, '\n', list->size - list->pos)) )
+					break;
+
+				list->pos = ep - list->base;
+				}
+			else if ( !strchr(",\n\r\t ", *cp) )
+				break;
+			}
+
+		/* Read more if there is no complete line and the buffer can accept something */
+		if ( (list->fd >= 0) && !list->eof && (list->pos || (list->size < CLI$S_LISTBUF))
+			&& ((list->pos == list->size) || !memchr(list->base + list->pos, '\n', list->size - list->pos)) )
+			{
+			if ( !(1 & (status = _cli$list_fill(list))) )
+				return	status;
+
+			continue;
+			}
+
+		if ( list->pos == list->size )
+			{
+			$ASCLEN(val) = 0;
+			return	STS$K_WARN;
+			}
+
+		cp = list->base + list->pos;
+
+		/* A comment line at the end of the stream without new line */
+		if ( *cp == '!' )
+			{
+			list->pos = list->size;
+			continue;
+			}
+
+		break;
+		}
+
+	/* Find end of the element */
+	for ( ep = cp; (ep < list->base + list->size) && (*ep != ',') && (*ep != '\n'); ep++);
+
+	list->pos = ep - list->base;
+
+	for ( ; (ep > cp) && strchr("\r\t ", ep[-1]); ep--);
+
+	len = ep - cp;
+	memset(val, 0, sizeof(ASC));
+	$ASCLEN(val) = $MIN(len, ASC$K_SZ - 1);
+	memcpy($ASCPTR(val), cp, $ASCLEN(val));
+
+	/* Check the element, its index is reported instead of the argument's index */
+	argv = clictx->argv;
+	clictx->argv = NULL;
+	clictx->tokidx = list->count++;
+	clictx->tokoff = 0;
+
+	if ( len >= ASC$K_SZ )
+		status = _cli$error(clictx, STS$K_ERROR, CLI$K_ERR_BADVALUE, list->pqdesc->pn ? list->pqdesc->pn : CLI$K_QUAL,
+			list->pqdesc, NULL, cp, len, ENAMETOOLONG);
+	else	status = cli$val_check(clictx, list->pqdesc, val);
+
+	clictx->argv = argv;
+
+	return	status;
+}
+
+int	cli$list_close	(
+	CLI_LIST	*list
+			)
+{
+	if ( list->mapped )
+		munmap(list->base, list->size);
+	else if ( list->base && (list->base != $ASCPTR(&list->inl)) )
+		_cli$free(list->clictx, list->base, CLI$S_LISTBUF);
+
+	if ( list->fd >= 0 )
+		close(list->fd);
+
+	_cli$free(list->clictx, list, sizeof(CLI_LIST));
+
+	return	STS$K_SUCCESS;
+}
+
+
+/*
+ *
+ *  DESCRIPTION: release resources has been allocated by cli$parse() routine.
+ *
+ *  INPUT:
+ *	ctx:	A CLI-context has been created by cli$parse()
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$cleanup	(
+		CLI_CTX	*clictx
+		)
+{
+
+CLI_ITEM	*avp, *avp2;
+
+	/* An abandoned action routine is still running, the last holder releases the context */
+	if ( __atomic_fetch_sub(&clictx->refs, 1, __ATOMIC_ACQ_REL) > 0 )
+		return	STS$K_SUCCESS;
+
+	/* Complete and release the output sink */
+	if ( clictx->out )
+		_cli$out_close(clictx);
+
+	/* Append the command's record to the traffic log */
+	if ( clictx->rec )
+		_cli$rec_commit(clictx);
+
+	/* Run over verb's items list and free has been alocated memory ...*/
+	for (avp = clictx->vlist; avp; )
+		{
+		avp2 = avp;
+		avp = avp->next;
+		_cli$item_free(clictx, avp2);
+		}
+
+	/* Run over vlaue's items list and free has been alocated memory ...*/
+	for (avp = clictx->avlist; avp; )
+		{
+		avp2 = avp;
+		avp = avp->next;
+		_cli$item_free(clictx, avp2);
+		}
+
+	__atomic_sub_fetch(&cli$gmstat.items, clictx->mstat.items, __ATOMIC_RELAXED);
+
+	/* Release CLI-context area and whatever is still accounted against it */
+	_cli$mem_release(clictx, clictx->mstat.bytes);
+	_cli$ctx_free(clictx);
+
+	return	STS$K_SUCCESS;
+}
+
+
+/*
+ *
+ *  DESCRIPTION: dispatch processing to action routine has been defined for the last verb's keyword.
+ *
+ *  INPUT:
+ *	ctx:	A CLI-context has been created by cli$parse()
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$dispatch	(
+		CLI_CTX	*clictx,
+		int	dflttmo
+			)
+{
+CLI_ITEM	*item;
+CLI_VERB	*verb;
+int		status, msecs;
+unsigned long long t0;
+CLI_RECHDR	*rec;
+
+	/* Last verb's item is a command to be executed */
+	if ( !(item = clictx->vtail) )
+		return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "No verb's item has been found in CLI-context") : STS$K_FATAL;
+
+	if ( !(verb = item->verb)  )
+		return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "No verb has been found in CLI-context") : STS$K_FATAL;
+
+	$IFTRACE(clictx->opts & CLI$M_OPTRACE, "Action routine=%#x, argument=%#x", verb->act_rtn, verb->act_arg);
+
+	/* Apply default deadline, don't start a command has been expired or cancelled */
+	if ( dflttmo && !clictx->deadline && (msecs = __atomic_load_n(&cli$limits.dsptmo, __ATOMIC_RELAXED)) )
+		cli$set_deadline(clictx, msecs);
+
+	if ( !(1 & (status = cli$check_cancel(clictx))) )
+		return	status;
+
+	if ( !verb->act_rtn )
+		return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_WARN, "No action routine has been defined") : STS$K_WARN;
+
+	t0 = clictx->rec ? _cli$now(CLOCK_MONOTONIC) : 0;
+
+	/* Output of the idempotent verb can be served from the cache */
+	if ( (verb->flags & CLI$M_VERB_IDEMPOTENT) && clictx->out )
+		status = _cli$cache_dispatch(clictx, verb);
+	else	status = verb->act_rtn(clictx, verb->act_arg);
+
+	if ( (rec = clictx->rec) )
+		{
+		rec->tdispatch = _cli$now(CLOCK_MONOTONIC) - t0;
+		rec->dsts = status;
+		rec->flags |= CLI$M_REC_DISPATCHED;
+		}
+
+	return	status;
+
+}
+
+int	cli$dispatch	(
+		CLI_CTX	*clictx
+			)
+{
+	return	_cli$dispatch(clictx, 1);
+}
+
+
+
+/*
+ * Deadlines and cooperative cancellation
+ */
+static	unsigned long long	_cli$now	(
+			clockid_t	clk
+				)
+{
+struct timespec	now;
+
+	clock_gettime(clk, &now);
+
+	return	now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/*
+ *
+ *  DESCRIPTION: set a deadline of the command relative to the current time.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	msecs:	a time budget in milliseconds, 0 - no deadline
+ *
+ *  RETURN:
+ *	SS$_NORMAL
+ *
+ */
+int	cli$set_deadline(
+		CLI_CTX	*clictx,
+		int	msecs
+			)
+{
+	clictx->deadline = msecs ? _cli$now(CLOCK_MONOTONIC) + msecs * 1000000ULL : 0;
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: request cancellation of the command, can be called from any thread.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *
+ *  RETURN:
+ *	SS$_NORMAL
+ *
+ */
+int	cli$cancel	(
+		CLI_CTX	*clictx
+			)
+{
+int	state = CLI$K_CANCEL_NONE;
+
+	__atomic_compare_exchange_n(&clictx->cancel, &state, CLI$K_CANCEL_REQ, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: check that the command can continue, is supposed to be polled by long running
+ *	action routines. The check is an atomic load and a coarse clock reading (no system call).
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *
+ *  RETURN:
+ *	SS$_NORMAL - continue
+ *	STS$K_ERROR - cancelled or deadline has been expired (CLI$K_ERR_CANCELLED/TIMEOUT)
+ *
+ */
+int	cli$check_cancel(
+		CLI_CTX	*clictx
+			)
+{
+int	state;
+
+	state = __atomic_load_n(&clictx->cancel, __ATOMIC_ACQUIRE);
+
+	if ( state == CLI$K_CANCEL_NONE )
+		{
+		if ( !clictx->deadline || (_cli$now(CLOCK_MONOTONIC_COARSE) < clictx->deadline) )
+			return	STS$K_SUCCESS;
+
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_TIMEOUT, 0, clictx->vtail ? clictx->vtail->verb : NULL,
+				NULL, NULL, 0, ETIMEDOUT);
+		}
+
+	/* Abandoned context is owned by the dispatcher's error record, don't touch it */
+	if ( state == CLI$K_CANCEL_ABANDON )
+		return	STS$K_ERROR;
+
+	return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_CANCELLED, 0, clictx->vtail ? clictx->vtail->verb : NULL,
+			NULL, NULL, 0, ECANCELED);
+}
+
+/*
+ * A block shared by the dispatcher and the thread running an action routine,
+ * the last one releases it.
+ */
+typedef struct __cli_dspblk__
+{
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+
+	CLI_CTX		*clictx;
+
+	int		done,
+			status,
+			refs;
+} CLI_DSPBLK;
+
+static	void	_cli$dspblk_release	(
+		CLI_DSPBLK	*dsp
+			)
+{
+	if ( __atomic_sub_fetch(&dsp->refs, 1, __ATOMIC_ACQ_REL) )
+		return;
+
+	pthread_cond_destroy(&dsp->cond);
+	pthread_mutex_destroy(&dsp->lock);
+	free(dsp);
+}
+
+static	void	*_cli$dsp_thread	(
+		void	*arg
+			)
+{
+CLI_DSPBLK	*dsp = arg;
+CLI_CTX		*clictx = dsp->clictx;
+int		status;
+
+	/* The deadline is watched by the dispatcher, only cancellation is seen by the routine */
+	status = _cli$dispatch(clictx, 0);
+
+	pthread_mutex_lock(&dsp->lock);
+	dsp->status = status;
+	dsp->done = 1;
+	pthread_cond_signal(&dsp->cond);
+	pthread_mutex_unlock(&dsp->lock);
+
+	/* Drop the thread's reference, the context is released here if it has been abandoned */
+	cli$cleanup(clictx);
+	_cli$dspblk_release(dsp);
+
+	return	NULL;
+}
+
+/*
+ *
+ *  DESCRIPTION: call the verb's action routine with a time budget.
+ *
+ *	By default the action routine is called in the current thread with the deadline set,
+ *	it's expected to poll cli$check_cancel() and return.
+ *
+ *	With CLI$M_DSP_ABANDON the routine is run by a separate thread, at the deadline the command
+ *	is marked as cancelled and the call returns without waiting: the routine keeps running
+ *	until its next cli$check_cancel(), a caller still calls cli$cleanup() as usual, the
+ *	context is released when the routine returns. An abandoned routine must not use
+ *	the context after cli$check_cancel() has failed, its errors are not recorded since
+ *	the error record is handed over to the caller. A thread is created per call,
+ *	so the mode is for commands whose worst case matters more than the start cost.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	msecs:	a time budget in milliseconds, 0 - no deadline
+ *	flags:	CLI$M_DSP_* options
+ *
+ *  RETURN:
+ *	a status of the action routine,
+ *	STS$K_ERROR - CLI$K_ERR_TIMEOUT, the command has been abandoned,
+ *	condition status
+ *
+ */
+int	cli$dispatch_timed	(
+		CLI_CTX	*clictx,
+		int	msecs,
+		int	flags
+			)
+{
+CLI_DSPBLK	*dsp;
+pthread_condattr_t attr;
+pthread_attr_t	tattr;
+pthread_t	tid;
+struct timespec	tmo;
+unsigned long long deadline;
+int		status = STS$K_SUCCESS, rc = 0, state = CLI$K_CANCEL_NONE;
+
+	if ( !(flags & CLI$M_DSP_ABANDON) || !msecs )
+		{
+		cli$set_deadline(clictx, msecs);
+		return	cli$dispatch(clictx);
+		}
+
+	/* The routine won't see the deadline, so the context's error record is written only here */
+	clictx->deadline = 0;
+	deadline = _cli$now(CLOCK_MONOTONIC) + msecs * 1000000ULL;
+
+	if ( !(dsp = calloc(1, sizeof(CLI_DSPBLK))) )
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_NOMEM, 0, NULL, NULL, NULL, 0, errno);
+
+	pthread_mutex_init(&dsp->lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&dsp->cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	dsp->clictx = clictx;
+	dsp->refs = 2;
+
+	/* The thread keeps its own reference to the context */
+	__atomic_add_fetch(&clictx->refs, 1, __ATOMIC_ACQ_REL);
+
+	pthread_attr_init(&tattr);
+	pthread_attr_setdetachstate(&tattr, PTHREAD_CREATE_DETACHED);
+
+	if ( (rc = pthread_create(&tid, &tattr, _cli$dsp_thread, dsp)) )
+		{
+		pthread_attr_destroy(&tattr);
+		__atomic_sub_fetch(&clictx->refs, 1, __ATOMIC_ACQ_REL);
+		dsp->refs = 1;
+		_cli$dspblk_release(dsp);
+
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_NOMEM, 0, NULL, NULL, NULL, 0, rc);
+		}
+
+	pthread_attr_destroy(&tattr);
+
+	tmo.tv_sec = deadline / 1000000000ULL;
+	tmo.tv_nsec = deadline % 1000000000ULL;
+
+	pthread_mutex_lock(&dsp->lock);
+
+	for ( rc = 0; !dsp->done && (rc != ETIMEDOUT); )
+		rc = pthread_cond_timedwait(&dsp->cond, &dsp->lock, &tmo);
+
+	if ( dsp->done )
+		status = dsp->status;
+	else	{
+		/* Tell the routine to leave the context alone, wait for its writers of the error record ... */
+		state = __atomic_exchange_n(&clictx->cancel, CLI$K_CANCEL_ABANDON, __ATOMIC_SEQ_CST);
+		status = STS$K_ERROR;
+
+		while ( __atomic_load_n(&clictx->errbusy, __ATOMIC_SEQ_CST) )
+			sched_yield();
+
+		/* ... the record is ours from now on */
+		if ( state == CLI$K_CANCEL_NONE )
+			status = _cli$error_rec(clictx, STS$K_ERROR, CLI$K_ERR_TIMEOUT, 0, clictx->vtail ? clictx->vtail->verb : NULL,
+				NULL, NULL, 0, ETIMEDOUT);
+		}
+
+	pthread_mutex_unlock(&dsp->lock);
+
+	_cli$dspblk_release(dsp);
+
+	return	status;
+}
+
+
+
+/*
+ * Buffered structured output sink
+ */
+struct __cli_out__
+{
+	int	fd,
+		fmt,
+		sock,		/* fd is a socket - sendmsg(MSG_NOSIGNAL)	*/
+		ncols,
+		nrecs,
+		widths [CLI$K_OUTCOLS];
+
+	ASC	names [CLI$K_OUTCOLS];
+
+	struct iovec iov [CLI$K_OUTIOV];	/* Filled chunks, iov_len - a fill	*/
+	int	niov;				/* A chunk is being filled	*/
+
+	CLI_BUF	*capture;			/* A copy of output for the cache	*/
+};
+
+/*
+ *
+ *  DESCRIPTION: write all filled chunks by single writev()/sendmsg(), continue on partial writes,
+ *	wait for POLLOUT on non-blocking descriptors until the command's deadline.
+ *
+ */
+static	int	_cli$out_write	(
+		CLI_CTX	*clictx
+			)
+{
+CLI_OUT	*out = clictx->out;
+struct iovec	iov [CLI$K_OUTIOV], *vp = iov;
+struct msghdr	msg = {0};
+struct pollfd	pfd = {.fd = out->fd, .events = POLLOUT};
+int	niov, i, tmo;
+ssize_t	rc;
+
+	for ( niov = i = 0; i <= out->niov; i++)
+		if ( out->iov[i].iov_len )
+			iov[niov++] = out->iov[i];
+
+	while ( niov )
+		{
+		if ( out->sock )
+			{
+			msg.msg_iov = vp;
+			msg.msg_iovlen = niov;
+			rc = sendmsg(out->fd, &msg, MSG_NOSIGNAL);
+			}
+		else	rc = writev(out->fd, vp, niov);
+
+		if ( rc < 0 )
+			{
+			if ( errno == EINTR )
+				continue;
+
+			if ( (errno != EAGAIN) && (errno != EWOULDBLOCK) )
+				return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_OUTPUT, 0, NULL, NULL, NULL, 0, errno);
+
+			tmo = clictx->deadline ? (int) ((clictx->deadline - $MIN(clictx->deadline, _cli$now(CLOCK_MONOTONIC))) / 1000000) : -1;
+
+			if ( !(rc = poll(&pfd, 1, tmo)) )
+				return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_TIMEOUT, 0, NULL, NULL, NULL, 0, ETIMEDOUT);
+
+			continue;
+			}
+
+		/* Skip has been written data */
+		for ( ; niov && ((size_t) rc >= vp->iov_len); rc -= vp->iov_len, vp++, niov--);
+
+		if ( niov )
+			{
+			vp->iov_base = (char *) vp->iov_base + rc;
+			vp->iov_len -= rc;
+			}
+		}
+
+	for ( i = 0; i <= out->niov; i++)
+		out->iov[i].iov_len = 0;
+
+	out->niov = 0;
+
+	return	STS$K_SUCCESS;
+}
+
+static	int	_cli$out_put	(
+		CLI_CTX	*clictx,
+	const	char	*buf,
+		size_t	len
+			)
+{
+CLI_OUT	*out = clictx->out;
+struct iovec *vp;
+size_t	sz;
+int	status;
+
+	if ( out->capture )
+		_cli$buf_add(out->capture, buf, len, CLI$S_CACHEOBJ);
+
+	while ( len )
+		{
+		vp = &out->iov[out->niov];
+
+		/* Chunks are allocated at first use and kept until the sink is closed */
+		if ( !vp->iov_base && !(vp->iov_base = _cli$alloc(clictx, CLI$S_OUTCHUNK)) )
+			return	STS$K_ERROR;
+
+		if ( vp->iov_len == CLI$S_OUTCHUNK )
+			{
+			if ( out->niov < CLI$K_OUTIOV - 1 )
+				out->niov++;
+			else if ( !(1 & (status = _cli$out_write(clictx))) )
+				return	status;
+
+			continue;
+			}
+
+		sz = $MIN(len, CLI$S_OUTCHUNK - vp->iov_len);
+		memcpy((char *) vp->iov_base + vp->iov_len, buf, sz);
+		vp->iov_len += sz;
+		buf += sz;
+		len -= sz;
+		}
+
+	return	STS$K_SUCCESS;
+}
+
+static	int	_cli$out_pad	(
+		CLI_CTX	*clictx,
+		int	len
+			)
+{
+static const char spaces [64] = "                                                                ";
+int	status = STS$K_SUCCESS;
+
+	for ( ; (len > 0) && (1 & status); len -= sizeof(spaces))
+		status = _cli$out_put(clictx, spaces, $MIN(len, (int) sizeof(spaces)));
+
+	return	status;
+}
+
+/* Put a value with CSV or JSON quoting, runs of plain characters are copied at once */
+static	int	_cli$out_quoted	(
+		CLI_CTX	*clictx,
+	const	char	*val,
+		int	fmt
+			)
+{
+const char *cp;
+char	esc[8];
+int	status;
+
+	if ( !(1 & (status = _cli$out_put(clictx, "\"", 1))) )
+		return	status;
+
+	for ( cp = val; *cp; cp++)
+		{
+		if ( fmt == CLI$K_OUT_CSV )
+			{
+			if ( *cp != '"' )
+				continue;
+
+			status = _cli$out_put(clictx, val, cp - val + 1);	/* Double the quote */
+			val = cp;
+			}
+		else if ( (*cp == '"') || (*cp == '\\') || ((unsigned char) *cp < 0x20) )
+			{
+			status = _cli$out_put(clictx, val, cp - val);
+
+			if ( (*cp == '"') || (*cp == '\\') )
+				snprintf(esc, sizeof(esc), "\\%c", *cp);
+			else	snprintf(esc, sizeof(esc), "\\u%04x", (unsigned char) *cp);
+
+			status = _cli$out_put(clictx, esc, strlen(esc));
+			val = cp + 1;
+			}
+
+		if ( !(1 & status) )
+			return	status;
+		}
+
+	if ( !(1 & (status = _cli$out_put(clictx, val, cp - val))) )
+		return	status;
+
+	return	_cli$out_put(clictx, "\"", 1);
+}
+
+/* Complete current JSON array, a next record should be preceded by a header */
+static	int	_cli$out_endtable	(
+		CLI_CTX	*clictx
+			)
+{
+CLI_OUT	*out = clictx->out;
+int	status = STS$K_SUCCESS;
+
+	if ( (out->fmt == CLI$K_OUT_JSON) && out->ncols )
+		status = _cli$out_put(clictx, out->nrecs ? "\n]\n" : "[]\n", 3);
+
+	out->ncols = out->nrecs = 0;
+
+	return	status;
+}
+
+/* Complete JSON array, write pending data, release the sink */
+static	int	_cli$out_close	(
+		CLI_CTX	*clictx
+			)
+{
+CLI_OUT	*out = clictx->out;
+int	status, i;
+
+	if ( 1 & (status = _cli$out_endtable(clictx)) )
+		status = _cli$out_write(clictx);
+
+	for ( i = 0; i < CLI$K_OUTIOV; i++)
+		if ( out->iov[i].iov_base )
+			_cli$free(clictx, out->iov[i].iov_base, CLI$S_OUTCHUNK);
+
+	_cli$free(clictx, out, sizeof(CLI_OUT));
+	clictx->out = NULL;
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: attach an output sink to the CLI-context, previous one is completed and released.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	fd:	a file descriptor (file, pipe, terminal or a client's socket), -1 - detach sink
+ *	fmt:	CLI$K_OUT_TEXT, CLI$K_OUT_CSV, CLI$K_OUT_JSON
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$set_output	(
+		CLI_CTX	*clictx,
+		int	fd,
+		int	fmt
+			)
+{
+CLI_OUT	*out;
+struct stat st;
+int	status = STS$K_SUCCESS;
+
+	if ( clictx->out )
+		status = _cli$out_close(clictx);
+
+	if ( fd < 0 )
+		return	status;
+
+	if ( !(out = _cli$alloc(clictx, sizeof(CLI_OUT))) )
+		return	STS$K_ERROR;
+
+	out->fd = fd;
+	out->fmt = fmt;
+	out->sock = !fstat(fd, &st) && S_ISSOCK(st.st_mode);
+
+	clictx->out = out;
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: declare columns of following records, a header line is put for TEXT and CSV.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	ncols:	a number of columns
+ *	names:	columns' names
+ *	widths:	columns' widths for the text table, NULL or 0 - a length of the name
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$put_header	(
+		CLI_CTX	*clictx,
+		int	ncols,
+	const	char	**names,
+	const	int	*widths
+			)
+{
+CLI_OUT	*out = clictx->out;
+int	i, len, status = STS$K_SUCCESS;
+
+	ncols = $MIN(ncols, CLI$K_OUTCOLS);
+
+	if ( !out )
+		{
+		for ( i = 0; i < ncols; i++)
+			$LOG(STS$K_INFO, "%s%s", i ? " | " : "", names[i]);
+		return	STS$K_SUCCESS;
+		}
+
+	/* A next table in the same JSON stream starts a new array */
+	status = _cli$out_endtable(clictx);
+
+	out->ncols = ncols;
+
+	for ( i = 0; (1 & status) && (i < ncols); i++)
+		{
+		/* A name is put by _cli$out_quoted() as a string, keep room for NUL */
+		len = strnlen(names[i], ASC$K_SZ - 1);
+		memcpy($ASCPTR(&out->names[i]), names[i], len);
+		$ASCPTR(&out->names[i])[len] = '\0';
+		out->names[i].len = len;
+		out->widths[i] = $MAX(len, (widths && widths[i]) ? widths[i] : 0);
+
+		if ( out->fmt == CLI$K_OUT_TEXT )
+			{
+			if ( 1 & (status = _cli$out_put(clictx, names[i], len)) )
+				status = (i < ncols - 1) ? _cli$out_pad(clictx, out->widths[i] - len + 2) : _cli$out_put(clictx, "\n", 1);
+			}
+		else if ( out->fmt == CLI$K_OUT_CSV )
+			{
+			status = strpbrk(names[i], ",\"\r\n") ? _cli$out_quoted(clictx, names[i], CLI$K_OUT_CSV) : _cli$out_put(clictx, names[i], len);
+
+			if ( 1 & status )
+				status = _cli$out_put(clictx, (i < ncols - 1) ? "," : "\r\n", (i < ncols - 1) ? 1 : 2);
+			}
+		}
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: put a record into the output sink, data is written when the buffer is full
+ *	or by cli$flush_output()/cli$cleanup(). Without sink the record is put by $LOG.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	nvals:	a number of values, should be equal to a number of columns
+ *	vals:	zero terminated strings, NULL - empty value
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$put_output	(
+		CLI_CTX	*clictx,
+		int	nvals,
+	const	char	**vals
+			)
+{
+CLI_OUT	*out = clictx->out;
+const char *val;
+char	line[1024];
+int	i, len, status = STS$K_SUCCESS;
+
+	nvals = $MIN(nvals, CLI$K_OUTCOLS);
+
+	if ( !out )
+		{
+		for ( len = i = 0; (i < nvals) && (len < (int) sizeof(line)); i++)
+			len += snprintf(line + len, sizeof(line) - len, "%s%s", i ? " | " : "", vals[i] ? vals[i] : "");
+
+		return	$LOG(STS$K_INFO, "%s", line);
+		}
+
+	if ( out->fmt == CLI$K_OUT_JSON )
+		status = _cli$out_put(clictx, out->nrecs ? ",\n{" : "[\n{", 3);
+
+	for ( i = 0; (1 & status) && (i < nvals); i++)
+		{
+		val = vals[i] ? vals[i] : "";
+
+		switch ( out->fmt )
+			{
+			case	CLI$K_OUT_CSV:
+				if ( strpbrk(val, ",\"\r\n") )
+					status = _cli$out_quoted(clictx, val, CLI$K_OUT_CSV);
+				else	status = _cli$out_put(clictx, val, strlen(val));
+
+				if ( 1 & status )
+					status = _cli$out_put(clictx, (i < nvals - 1) ? "," : "\r\n", (i < nvals - 1) ? 1 : 2);
+				break;
+
+			case	CLI$K_OUT_JSON:
+				if ( i )
+					status = _cli$out_put(clictx, ",", 1);
+
+				if ( (1 & status) && (1 & (status = _cli$out_quoted(clictx, (i < out->ncols) ? $ASCPTR(&out->names[i]) : "", CLI$K_OUT_JSON))) )
+					if ( 1 & (status = _cli$out_put(clictx, ":", 1)) )
+						status = _cli$out_quoted(clictx, val, CLI$K_OUT_JSON);
+				break;
+
+			default:
+				len = strlen(val);
+
+				if ( 1 & (status = _cli$out_put(clictx, val, len)) )
+					status = (i < nvals - 1) ? _cli$out_pad(clictx, $MAX(((i < out->ncols) ? out->widths[i] : 0) - len, 0) + 2)
+						: _cli$out_put(clictx, "\n", 1);
+			}
+		}
+
+	if ( (1 & status) && (out->fmt == CLI$K_OUT_JSON) )
+		status = _cli$out_put(clictx, "}", 1);
+
+	out->nrecs++;
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: write has been accumulated output.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$flush_output(
+		CLI_CTX	*clictx
+			)
+{
+	return	clictx->out ? _cli$out_write(clictx) : STS$K_SUCCESS;
+}
+
+
+
+/*
+ * Result cache of the idempotent verbs
+ */
+enum	{
+	CLI$K_CACHE_PENDING = 0,	/* Action routine is being executed	*/
+	CLI$K_CACHE_READY,		/* Output is cached			*/
+	CLI$K_CACHE_FAILED		/* Not cacheable, waiters should retry	*/
+};
+
+#define	CLI$K_CACHEBUCKETS	256
+
+typedef struct __cli_cacheent__
+{
+	struct __cli_cacheent__ *next;
+
+	unsigned	hash;
+	CLI_BUF		key;
+	int		poff,		/* The verb path in the key: "\x1fSET\x1fVOLUME" */
+			plen;
+
+	int		state,
+			status,		/* A status of the action routine	*/
+			ncols,		/* Sink's state after the command	*/
+			nrecs,
+			refs,
+			linked;
+
+	unsigned long long expires;	/* CLOCK_MONOTONIC_COARSE, nsecs	*/
+
+	CLI_BUF		data;		/* A captured output			*/
+} CLI_CACHEENT;
+
+static	pthread_mutex_t	cli$cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static	pthread_cond_t	cli$cache_cond;		/* CLOCK_MONOTONIC, see _cli$cache_init() */
+static	pthread_once_t	cli$cache_once = PTHREAD_ONCE_INIT;
+static	CLI_CACHEENT	*cli$cache [CLI$K_CACHEBUCKETS];
+static	CLI_CACHESTAT	cli$cache_stats;
+
+static	void	_cli$cache_free	(
+		CLI_CACHEENT	*ent
+			)
+{
+	free(ent->key.ptr);
+	free(ent->data.ptr);
+	free(ent);
+}
+
+/* Must be called under the cache lock */
+static	void	_cli$cache_unref	(
+		CLI_CACHEENT	*ent
+			)
+{
+	if ( !--ent->refs && !ent->linked )
+		_cli$cache_free(ent);
+}
+
+/* Must be called under the cache lock */
+static	void	_cli$cache_unlink	(
+		CLI_CACHEENT	*ent
+			)
+{
+CLI_CACHEENT	**pent;
+
+	for ( pent = &cli$cache[ent->hash % CLI$K_CACHEBUCKETS]; *pent; pent = &(*pent)->next)
+		if ( *pent == ent )
+			{
+			*pent = ent->next;
+			ent->linked = 0;
+			cli$cache_stats.entries--;
+
+			if ( !ent->refs )
+				_cli$cache_free(ent);
+
+			break;
+			}
+}
+
+/* Drop expired results, must be called under the cache lock */
+static	void	_cli$cache_sweep	(void)
+{
+CLI_CACHEENT	*ent, *next;
+unsigned long long now = _cli$now(CLOCK_MONOTONIC_COARSE);
+int	i;
+
+	for ( i = 0; i < CLI$K_CACHEBUCKETS; i++)
+		for ( ent = cli$cache[i]; ent; ent = next)
+			{
+			next = ent->next;
+
+			if ( (ent->state == CLI$K_CACHE_READY) && (ent->expires <= now) )
+				_cli$cache_unlink(ent);
+			}
+}
+
+/*
+ *
+ *  DESCRIPTION: build a key of the command: verbs path, sink's format, parameters and
+ *	qualifiers in the definition order with normalized values (keywords - full name,
+ *	numbers - decimal), so '/FU /LOG=TR' and '/LOG=TRACE /FULL' are the same command.
+ *
+ */
+static	int	_cli$cache_cmpitem	(
+		CLI_ITEM *a,
+		CLI_ITEM *b
+			)
+{
+unsigned pa = a->pqdesc->pn ? a->pqdesc->pn : CLI$K_QUAL, pb = b->pqdesc->pn ? b->pqdesc->pn : CLI$K_QUAL;
+int	rc;
+
+	if ( pa != pb )
+		return	(pa > pb) - (pa < pb);
+
+	if ( pa != CLI$K_QUAL )
+		return	0;
+
+	if ( (rc = memcmp($ASCPTR(&a->pqdesc->name), $ASCPTR(&b->pqdesc->name), $MIN($ASCLEN(&a->pqdesc->name), $ASCLEN(&b->pqdesc->name)))) )
+		return	rc;
+
+	return	$ASCLEN(&a->pqdesc->name) - $ASCLEN(&b->pqdesc->name);
+}
+
+static	int	_cli$cache_key	(
+		CLI_CTX	*clictx,
+		CLI_BUF	*key,
+		int	*poff,
+		int	*plen
+			)
+{
+CLI_ITEM	*avp, *items[CLI$K_MAXARGC];
+CLI_KEYWORD	*kwd;
+int		nitems = 0, i;
+char		num[ASC$K_SZ + 1];	/* A value can be not NUL terminated	*/
+
+	_cli$buf_put(key, "%d", clictx->out->fmt);
+	*poff = key->len;
+
+	for ( avp = clictx->vlist; avp; avp = avp->next)
+		_cli$buf_put(key, "\x1f%.*s", $ASC(&avp->verb->name));
+
+	*plen = key->len - *poff;
+
+	/*
+	 * Items are keyed by names, not by definitions' addresses: arrays are replaced by cli$tbl_*(),
+	 * order is P1 ... P8, then qualifiers by name, repeated qualifiers keep command line order.
+	 */
+	for ( avp = clictx->avlist; avp && (nitems < CLI$K_MAXARGC); avp = avp->next)
+		{
+		for ( i = nitems++; i && (_cli$cache_cmpitem(items[i - 1], avp) > 0); i--)
+			items[i] = items[i - 1];
+
+		items[i] = avp;
+		}
+
+	if ( avp )
+		return	STS$K_ERROR;
+
+	for ( i = 0; i < nitems; i++)
+		{
+		avp = items[i];
+
+		if ( avp->pqdesc->pn )
+			_cli$buf_put(key, "\x1eP%d=", avp->pqdesc->pn);
+		else	_cli$buf_put(key, "\x1e/%.*s=", $ASC(&avp->pqdesc->name));
+
+		switch ( avp->pqdesc->type )
+			{
+			case	CLI$K_NUM:
+				snprintf(num, sizeof(num), "%.*s", $ASC(&avp->val));
+				_cli$buf_put(key, "%llu", strtoull(num, NULL, 0));
+				break;
+
+			case	CLI$K_KWD:
+				kwd = NULL;
+
+				if ( avp->pqdesc->kwd && $ASCLEN(&avp->val)
+					&& (1 & cli$check_keyword(clictx, $ASCPTR(&avp->val), $ASCLEN(&avp->val), avp->pqdesc->kwd, &kwd)) && kwd )
+					{
+					_cli$buf_put(key, "%.*s", $ASC(&kwd->name));
+					break;
+					}
+				/* Fall through */
+
+			default:
+				_cli$buf_add(key, $ASCPTR(&avp->val), $ASCLEN(&avp->val), INT_MAX);
+			}
+		}
+
+	return	key->sts == STS$K_ERROR ? STS$K_ERROR : STS$K_SUCCESS;
+}
+
+/* Write cached output into the sink, restore sink's table state */
+static	int	_cli$cache_replay	(
+		CLI_CTX		*clictx,
+		CLI_CACHEENT	*ent
+			)
+{
+int	status;
+
+	if ( !(1 & (status = _cli$out_endtable(clictx))) )
+		return	status;
+
+	if ( !(1 & (status = _cli$out_put(clictx, ent->data.ptr, ent->data.len))) )
+		return	status;
+
+	clictx->out->ncols = ent->ncols;
+	clictx->out->nrecs = ent->nrecs;
+
+	return	ent->status;
+}
+
+/* Deadlines are CLOCK_MONOTONIC, so is the condition variable */
+static	void	_cli$cache_init	(void)
+{
+pthread_condattr_t attr;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&cli$cache_cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+static	int	_cli$cache_dispatch	(
+		CLI_CTX		*clictx,
+		CLI_VERB	*verb
+			)
+{
+CLI_BUF		key = {0};
+CLI_CACHEENT	*ent;
+unsigned	hash = 2166136261U;
+struct timespec	tmo;
+int		i, status, rc, poff, plen;
+
+	pthread_once(&cli$cache_once, _cli$cache_init);
+
+	/* Cannot build a key - just execute */
+	if ( !(1 & _cli$cache_key(clictx, &key, &poff, &plen)) )
+		{
+		free(key.ptr);
+		return	verb->act_rtn(clictx, verb->act_arg);
+		}
+
+	for ( i = 0; i < key.len; i++)
+		hash = (hash ^ (unsigned char) key.ptr[i]) * 16777619U;
+
+	tmo.tv_sec = clictx->deadline / 1000000000ULL;
+	tmo.tv_nsec = clictx->deadline % 1000000000ULL;
+
+	pthread_mutex_lock(&cli$cache_lock);
+
+	for ( ;; )
+		{
+		for ( ent = cli$cache[hash % CLI$K_CACHEBUCKETS]; ent; ent = ent->next)
+			if ( (ent->hash == hash) && (ent->key.len == key.len) && !memcmp(ent->key.ptr, key.ptr, key.len) )
+				break;
+
+		if ( ent && (ent->state == CLI$K_CACHE_READY) && (ent->expires <= _cli$now(CLOCK_MONOTONIC_COARSE)) )
+			{
+			_cli$cache_unlink(ent);
+			ent = NULL;
+			}
+
+		if ( !ent )
+			break;
+
+		ent->refs++;
+
+		/* Identical command is in flight - wait for its result */
+		if ( ent->state == CLI$K_CACHE_PENDING )
+			{
+			cli$cache_stats.coalesced++;
+
+			for ( rc = 0; (ent->state == CLI$K_CACHE_PENDING) && (rc != ETIMEDOUT); )
+				rc = clictx->deadline ? pthread_cond_timedwait(&cli$cache_cond, &cli$cache_lock, &tmo)
+					: pthread_cond_wait(&cli$cache_cond, &cli$cache_lock);
+
+			if ( ent->state == CLI$K_CACHE_PENDING )
+				{
+				_cli$cache_unref(ent);
+				pthread_mutex_unlock(&cli$cache_lock);
+				free(key.ptr);
+
+				return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_TIMEOUT, 0, verb, NULL, NULL, 0, ETIMEDOUT);
+				}
+			}
+
+		if ( ent->state == CLI$K_CACHE_READY )
+			{
+			cli$cache_stats.hits++;
+			pthread_mutex_unlock(&cli$cache_lock);
+
+			/* Cached data is immutable, so it's written without lock */
+			status = _cli$cache_replay(clictx, ent);
+
+			pthread_mutex_lock(&cli$cache_lock);
+			_cli$cache_unref(ent);
+			pthread_mutex_unlock(&cli$cache_lock);
+			free(key.ptr);
+
+			return	status;
+			}
+
+		/* Executor has failed, try again: probably we become an executor */
+		_cli$cache_unref(ent);
+		}
+
+	cli$cache_stats.misses++;
+
+	if ( cli$cache_stats.entries >= CLI$K_CACHEMAX )
+		_cli$cache_sweep();
+
+	/* No room or memory - just execute */
+	if ( (cli$cache_stats.entries >= CLI$K_CACHEMAX) || !(ent = calloc(1, sizeof(CLI_CACHEENT))) )
+		{
+		pthread_mutex_unlock(&cli$cache_lock);
+		free(key.ptr);
+
+		return	verb->act_rtn(clictx, verb->act_arg);
+		}
+
+	ent->hash = hash;
+	ent->key = key;
+	ent->poff = poff;
+	ent->plen = plen;
+	ent->state = CLI$K_CACHE_PENDING;
+	ent->refs = 1;
+	ent->linked = 1;
+	ent->next = cli$cache[hash % CLI$K_CACHEBUCKETS];
+	cli$cache[hash % CLI$K_CACHEBUCKETS] = ent;
+	cli$cache_stats.entries++;
+
+	pthread_mutex_unlock(&cli$cache_lock);
+
+	/* Execute the command, capture output from a clean table's state */
+	if ( 1 & (status = _cli$out_endtable(clictx)) )
+		{
+		clictx->out->capture = &ent->data;
+		status = verb->act_rtn(clictx, verb->act_arg);
+		clictx->out->capture = NULL;
+		}
+
+	pthread_mutex_lock(&cli$cache_lock);
+
+	/* Has been invalidated while executing, or not cacheable result */
+	if ( ent->linked && (1 & status) && (ent->data.sts != STS$K_ERROR) )
+		{
+		ent->state = CLI$K_CACHE_READY;
+		ent->status = status;
+		ent->ncols = clictx->out->ncols;
+		ent->nrecs = clictx->out->nrecs;
+		ent->expires = _cli$now(CLOCK_MONOTONIC_COARSE) + (verb->ttl ? verb->ttl : CLI$K_CACHETTL) * 1000000ULL;
+		}
+	else	{
+		ent->state = CLI$K_CACHE_FAILED;
+
+		if ( ent->linked )
+			_cli$cache_unlink(ent);
+		}
+
+	pthread_cond_broadcast(&cli$cache_cond);
+	_cli$cache_unref(ent);
+	pthread_mutex_unlock(&cli$cache_lock);
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: drop cached results of the verb and its subverbs, e.g. after a command has changed
+ *	the data are shown by the verb; commands in flight are not cached. Entries are keyed by names,
+ *	so a verb is matched after cli$tbl_*() updates and plugin's binding too.
+ *
+ *  INPUT:
+ *	path:	a sequence of full verb names separated by spaces (see cli$tbl_add_verb()),
+ *		NULL or empty string - all verbs
+ *
+ *  RETURN:
+ *	SS$_NORMAL
+ *
+ */
+int	cli$cache_invalidate	(
+		char	*path
+			)
+{
+CLI_CACHEENT	*ent, *next;
+CLI_BUF		pfx = {0};
+char		*cp, *ep;
+int		i;
+
+	/* Build a key's prefix: "\x1fSET\x1fVOLUME" */
+	for ( cp = path; cp && *cp; cp = ep)
+		{
+		for ( ; (*cp == ' ') || (*cp == '\t'); cp++);
+		for ( ep = cp; *ep && (*ep != ' ') && (*ep != '\t'); ep++);
+
+		if ( ep > cp )
+			_cli$buf_put(&pfx, "\x1f%.*s", (int) (ep - cp), cp);
+		}
+
+	if ( pfx.sts == STS$K_ERROR )
+		{
+		free(pfx.ptr);
+		return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+		}
+
+	pthread_mutex_lock(&cli$cache_lock);
+
+	for ( i = 0; i < CLI$K_CACHEBUCKETS; i++)
+		for ( ent = cli$cache[i]; ent; ent = next)
+			{
+			next = ent->next;
+
+			/* Match whole names: "SET" is a prefix of "SET VOLUME", but not of "SETUP" */
+			if ( (pfx.len > ent->plen) || strncasecmp(ent->key.ptr + ent->poff, pfx.ptr, pfx.len)
+				|| ((pfx.len < ent->plen) && (ent->key.ptr[ent->poff + pfx.len] != '\x1f')) )
+				continue;
+
+			_cli$cache_unlink(ent);
+			}
+
+	pthread_mutex_unlock(&cli$cache_lock);
+
+	free(pfx.ptr);
+
+	return	STS$K_SUCCESS;
+}
+
+int	cli$cache_stat	(
+		CLI_CACHESTAT	*stat
+			)
+{
+	pthread_mutex_lock(&cli$cache_lock);
+	*stat = cli$cache_stats;
+	pthread_mutex_unlock(&cli$cache_lock);
+
+	return	STS$K_SUCCESS;
+}
+
+
+
+/*
+ * Priority-class scheduler of the commands
+ */
+#define	CLI$K_SCHED_VTSCALE	(1024ULL * 1024ULL)	/* A unit of the virtual time	*/
+
+static const int cli$sched_weights [CLI$K_SCHED_CLASSES] = {
+		[CLI$K_SCHED_NORMAL] = 4,
+		[CLI$K_SCHED_INTERACTIVE] = 16,
+		[CLI$K_SCHED_BATCH] = 1 };
+
+typedef struct __cli_schedreq__
+{
+	struct __cli_schedreq__ *next;
+
+	CLI_CTX		*clictx;
+	CLI_SCHEDAST	ast;
+	void		*arg;
+
+	int		cost;
+	unsigned long long enqueued;	/* CLOCK_MONOTONIC, nsecs	*/
+} CLI_SCHEDREQ;
+
+struct __cli_sched__
+{
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+
+	int		nworkers,
+			reserved,
+			stop,
+			nbulk,		/* Workers are busy with non-interactive	*/
+			weights [CLI$K_SCHED_CLASSES];
+
+	struct	{
+		CLI_SCHEDREQ	*head, *tail;
+		unsigned long long vtime;	/* Virtual finish time of the class	*/
+	} q [CLI$K_SCHED_CLASSES];
+
+	CLI_SCHEDSTAT	stat;
+
+	pthread_t	tids [];
+};
+
+/*
+ *
+ *  DESCRIPTION: pick a class to be served: a non-empty class with the least virtual time,
+ *	non-interactive classes are not eligible when all non-reserved workers are busy with them.
+ *	Must be called under the scheduler's lock.
+ *
+ *  RETURN:
+ *	a class, -1 - nothing to run
+ *
+ */
+static	int	_cli$sched_pick	(
+		CLI_SCHED	*sched
+			)
+{
+int	cls, best = -1;
+
+	for ( cls = 0; cls < CLI$K_SCHED_CLASSES; cls++)
+		{
+		if ( !sched->q[cls].head )
+			continue;
+
+		if ( (cls != CLI$K_SCHED_INTERACTIVE) && (sched->nbulk >= sched->nworkers - sched->reserved) )
+			continue;
+
+		if ( (best < 0) || (sched->q[cls].vtime < sched->q[best].vtime) )
+			best = cls;
+		}
+
+	return	best;
+}
+
+static	void	*_cli$sched_worker	(
+		void	*arg
+			)
+{
+CLI_SCHED	*sched = arg;
+CLI_SCHEDREQ	*req;
+unsigned long long wait;
+int		cls, status;
+
+	pthread_mutex_lock(&sched->lock);
+
+	for ( ;; )
+		{
+		while ( !sched->stop && (0 > (cls = _cli$sched_pick(sched))) )
+			pthread_cond_wait(&sched->cond, &sched->lock);
+
+		if ( sched->stop )
+			break;
+
+		req = sched->q[cls].head;
+
+		if ( !(sched->q[cls].head = req->next) )
+			sched->q[cls].tail = NULL;
+
+		/* Charge the class by cost of the command in proportion to its share */
+		sched->q[cls].vtime += req->cost * CLI$K_SCHED_VTSCALE / sched->weights[cls];
+
+		wait = _cli$now(CLOCK_MONOTONIC) - req->enqueued;
+		sched->stat.cls[cls].depth--;
+		sched->stat.cls[cls].waitsum += wait;
+		sched->stat.cls[cls].waitmax = $MAX(sched->stat.cls[cls].waitmax, wait);
+		sched->stat.busy++;
+		sched->nbulk += (cls != CLI$K_SCHED_INTERACTIVE);
+
+		pthread_mutex_unlock(&sched->lock);
+
+		/* A deadline has been expired in the queue is detected by the cli$dispatch() */
+		status = cli$dispatch(req->clictx);
+
+		if ( req->ast )
+			req->ast(req->clictx, status, req->arg);
+
+		free(req);
+
+		pthread_mutex_lock(&sched->lock);
+
+		sched->stat.cls[cls].completed++;
+		sched->stat.busy--;
+
+		/* A non-interactive slot has been released, other workers can pick it */
+		if ( cls != CLI$K_SCHED_INTERACTIVE )
+			{
+			sched->nbulk--;
+			pthread_cond_signal(&sched->cond);
+			}
+		}
+
+	pthread_mutex_unlock(&sched->lock);
+
+	return	NULL;
+}
+
+/*
+ *
+ *  DESCRIPTION: create a scheduler and start its workers.
+ *
+ *  INPUT:
+ *	cfg:	a configuration, weights are relative shares of the classes (0 - default)
+ *
+ *  OUTPUT:
+ *	sched:	an address to accept a scheduler
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$sched_init	(
+		CLI_SCHED	**sched,
+		CLI_SCHEDCFG	*cfg
+			)
+{
+CLI_SCHED	*sp;
+int		i, rc;
+
+	if ( cfg->nworkers < 1 )
+		return	$LOG(STS$K_ERROR, "Illegal number of workers (%d)", cfg->nworkers);
+
+	if ( !(sp = calloc(1, sizeof(CLI_SCHED) + cfg->nworkers * sizeof(pthread_t))) )
+		return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+
+	pthread_mutex_init(&sp->lock, NULL);
+	pthread_cond_init(&sp->cond, NULL);
+
+	/* At least one worker serves all classes */
+	sp->reserved = $MAX(0, $MIN(cfg->reserved, cfg->nworkers - 1));
+
+	for ( i = 0; i < CLI$K_SCHED_CLASSES; i++)
+		sp->weights[i] = cfg->weights[i] > 0 ? cfg->weights[i] : cli$sched_weights[i];
+
+	for ( i = 0; i < cfg->nworkers; i++, sp->nworkers++)
+		if ( (rc = pthread_create(&sp->tids[i], NULL, _cli$sched_worker, sp)) )
+			{
+			cli$sched_free(sp);
+			return	$LOG(STS$K_FATAL, "Cannot start worker thread, errno=%d", rc);
+			}
+
+	*sched = sp;
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: queue a command has been parsed for execution, the class and cost are taken
+ *	from the command's verb. The 'ast' routine is called by the worker after cli$dispatch(),
+ *	the CLI-context is owned by the scheduler until then.
+ *
+ *  INPUT:
+ *	sched:	A scheduler has been created by cli$sched_init()
+ *	clictx:	A CLI-context has been created by cli$parse()
+ *	ast:	a completion routine, NULL - none
+ *	arg:	an argument to be passed to the ast
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$sched_submit(
+		CLI_SCHED	*sched,
+		CLI_CTX		*clictx,
+		CLI_SCHEDAST	ast,
+		void		*arg
+			)
+{
+CLI_SCHEDREQ	*req;
+CLI_VERB	*verb;
+unsigned long long vmin = ~0ULL;
+int		cls, i;
+
+	if ( !clictx->vtail || !(verb = clictx->vtail->verb) )
+		return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "No verb has been found in CLI-context") : STS$K_FATAL;
+
+	if ( !(req = calloc(1, sizeof(CLI_SCHEDREQ))) )
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_NOMEM, 0, NULL, NULL, NULL, 0, errno);
+
+	cls = ((unsigned) verb->sched < CLI$K_SCHED_CLASSES) ? verb->sched : CLI$K_SCHED_NORMAL;
+
+	req->clictx = clictx;
+	req->ast = ast;
+	req->arg = arg;
+	req->cost = verb->cost > 0 ? verb->cost : 1;
+	req->enqueued = _cli$now(CLOCK_MONOTONIC);
+
+	pthread_mutex_lock(&sched->lock);
+
+	if ( sched->stop )
+		{
+		pthread_mutex_unlock(&sched->lock);
+		free(req);
+
+		return	_cli$error(clictx, STS$K_ERROR, CLI$K_ERR_CANCELLED, 0, verb, NULL, NULL, 0, ECANCELED);
+		}
+
+	/* A class becomes active: don't let it use a credit has been saved while idle */
+	if ( !sched->q[cls].head )
+		{
+		for ( i = 0; i < CLI$K_SCHED_CLASSES; i++)
+			if ( sched->q[i].head )
+				vmin = $MIN(vmin, sched->q[i].vtime);
+
+		if ( vmin != ~0ULL )
+			sched->q[cls].vtime = $MAX(sched->q[cls].vtime, vmin);
+
+		sched->q[cls].head = req;
+		}
+	else	sched->q[cls].tail->next = req;
+
+	sched->q[cls].tail = req;
+
+	sched->stat.cls[cls].depth++;
+	sched->stat.cls[cls].submitted++;
+
+	pthread_cond_broadcast(&sched->cond);
+	pthread_mutex_unlock(&sched->lock);
+
+	return	STS$K_SUCCESS;
+}
+
+int	cli$sched_stat	(
+		CLI_SCHED	*sched,
+		CLI_SCHEDSTAT	*stat
+			)
+{
+	pthread_mutex_lock(&sched->lock);
+	*stat = sched->stat;
+	pthread_mutex_unlock(&sched->lock);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: stop workers (running commands are completed), the commands still in queue
+ *	are completed with CLI$K_ERR_CANCELLED, release the scheduler.
+ *
+ *  INPUT:
+ *	sched:	A scheduler has been created by cli$sched_init()
+ *
+ *  RETURN:
+ *	SS$_NORMAL
+ *
+ */
+int	cli$sched_free	(
+		CLI_SCHED	*sched
+			)
+{
+CLI_SCHEDREQ	*req;
+CLI_VERB	*verb;
+int		i, cls, status;
+
+	pthread_mutex_lock(&sched->lock);
+	sched->stop = 1;
+	pthread_cond_broadcast(&sched->cond);
+	pthread_mutex_unlock(&sched->lock);
+
+	for ( i = 0; i < sched->nworkers; i++)
+		pthread_join(sched->tids[i], NULL);
+
+	for ( cls = 0; cls < CLI$K_SCHED_CLASSES; cls++)
+		while ( (req = sched->q[cls].head) )
+			{
+			sched->q[cls].head = req->next;
+			verb = req->clictx->vtail->verb;
+			status = _cli$error(req->clictx, STS$K_ERROR, CLI$K_ERR_CANCELLED, 0, verb, NULL, NULL, 0, ECANCELED);
+
+			if ( req->ast )
+				req->ast(req->clictx, status, req->arg);
+
+			free(req);
+			}
+
+	pthread_cond_destroy(&sched->cond);
+	pthread_mutex_destroy(&sched->lock);
+	free(sched);
+
+	return	STS$K_SUCCESS;
+}
+
+
+
+/*
+ * Runtime-mutable command table stuff
+ */
+typedef struct __cli_tblblk__ {
+	struct __cli_tblblk__ *next;	/* Linked list stuff			*/
+	void		*blk;		/* An array has been allocated by table	*/
+} CLI_TBLBLK;
+
+struct __cli_table__ {
+	CLI_VERB	*root;		/* A current snapshot of the verbs tree	*/
+	unsigned	version,	/* Incremented on every publication	*/
+			epoch;		/* Grace period's counter		*/
+	int		readers[2];	/* Readers in the even/odd epoch	*/
+
+	pthread_mutex_t	lock;		/* Serialize writers			*/
+	CLI_TBLBLK	*blks;		/* Arrays are owned by the table	*/
+};
+
+/*
+ *
+ *  DESCRIPTION: allocate a memory block for a new verbs/qualifiers array, remember it in the table's
+ *		list of owned blocks to be released at replacing.
+ *
+ *  INPUT:
+ *	tbl:	a command table
+ *	sz:	a size of block
+ *
+ *  RETURN:
+ *	an address of the block, NULL - insufficient memory
+ *
+ */
+static	void	*_cli$tbl_alloc	(
+		CLI_TABLE	*tbl,
+			size_t	sz
+			)
+{
+CLI_TBLBLK	*blk;
+
+	if ( !(blk = calloc(1, sizeof(CLI_TBLBLK))) )
+		return	NULL;
+
+	if ( !(blk->blk = calloc(1, sz)) )
+		{
+		free(blk);
+		return	NULL;
+		}
+
+	blk->next = tbl->blks;
+	tbl->blks = blk;
+
+	return	blk->blk;
+}
+
+/*
+ *
+ *  DESCRIPTION: move a block from the list of the owned blocks to the retired list,
+ *		arrays which has not been allocated by the table (static tables) are not touched.
+ *
+ *  INPUT:
+ *	tbl:	a command table
+ *	ptr:	an address of array to be retired
+ *
+ *  IMPLICIT OUTPUT:
+ *	retired:	a list of retired blocks
+ *
+ */
+static	void	_cli$tbl_retire	(
+		CLI_TABLE	*tbl,
+			void	*ptr,
+		CLI_TBLBLK	**retired
+			)
+{
+CLI_TBLBLK	**pblk, *blk;
+
+	for ( pblk = &tbl->blks; (blk = *pblk); pblk = &blk->next)
+		{
+		if ( blk->blk != ptr )
+			continue;
+
+		*pblk = blk->next;
+		blk->next = *retired;
+		*retired = blk;
+
+		return;
+		}
+}
+
+/* Release a block has been allocated by the table but has never been published */
+static	void	_cli$tbl_unalloc	(
+		CLI_TABLE	*tbl,
+			void	*ptr
+			)
+{
+CLI_TBLBLK	*retired = NULL;
+
+	_cli$tbl_retire(tbl, ptr, &retired);
+
+	if ( retired )
+		{
+		free(retired->blk);
+		free(retired);
+		}
+}
+
+/* Retire table-owned arrays of the verb and all its subverbs */
+static	void	_cli$tbl_retire_verb	(
+		CLI_TABLE	*tbl,
+		CLI_VERB	*verb,
+		CLI_TBLBLK	**retired
+			)
+{
+CLI_VERB	*sub;
+
+	for ( sub = verb->next; sub && $ASCLEN(&sub->name); sub++)
+		_cli$tbl_retire_verb(tbl, sub, retired);
+
+	_cli$tbl_retire(tbl, verb->next, retired);
+	_cli$tbl_retire(tbl, verb->params, retired);
+	_cli$tbl_retire(tbl, verb->quals, retired);
+}
+
+/*
+ *
+ *  DESCRIPTION: wait for a grace period - until all readers have been entered before new
+ *		snapshot's publication will leave the table.
+ *
+ *  INPUT:
+ *	tbl:	a command table
+ *
+ */
+static	void	_cli$tbl_sync	(
+		CLI_TABLE	*tbl
+			)
+{
+unsigned	epoch;
+
+	epoch = __atomic_load_n(&tbl->epoch, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&tbl->epoch, epoch + 1, __ATOMIC_SEQ_CST);
+
+	while ( __atomic_load_n(&tbl->readers[epoch & 1], __ATOMIC_SEQ_CST) )
+		sched_yield();
+}
+
+static	int	_cli$tbl_count	(
+		CLI_VERB	*verbs
+			)
+{
+int	count = 0;
+
+	for ( ; verbs && $ASCLEN(&verbs->name); verbs++, count++);
+
+	return	count;
+}
+
+static	int	_cli$tbl_find	(
+		CLI_VERB	*verbs,
+			char	*name,
+			int	len
+			)
+{
+int	i;
+
+	for ( i = 0; verbs && $ASCLEN(&verbs[i].name); i++)
+		if ( (len == $ASCLEN(&verbs[i].name)) && !strncasecmp(name, $ASCPTR(&verbs[i].name), len) )
+			return	i;
+
+	return	-1;
+}
+
+/*
+ *
+ *  DESCRIPTION: resolve a path of verbs in the given verbs tree.
+ *
+ *  INPUT:
+ *	verbs:	a root of the verbs tree
+ *	path:	a sequence of full verb names separated by spaces
+ *
+ *  OUTPUT:
+ *	arrs:	arrays on the path, arrs[0] is a root
+ *	idxs:	an index of the verb in the corresponding array
+ *	depth:	a number of resolved verbs
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$tbl_path	(
+		CLI_VERB	*verbs,
+			char	*path,
+		CLI_VERB	**arrs,
+			int	*idxs,
+			int	*depth
+			)
+{
+int	len, lvl;
+char	*cp;
+
+	arrs[lvl = 0] = verbs;
+
+	for ( cp = path; cp && *cp; )
+		{
+		for ( ; *cp == ' ' || *cp == '\t'; cp++);
+
+		if ( !*cp )
+			break;
+
+		for ( len = 0; cp[len] && (cp[len] != ' ') && (cp[len] != '\t'); len++);
+
+		if ( lvl >= CLI$S_MAXDEPTH )
+			return	$LOG(STS$K_ERROR, "Path '%s' is too deep", path);
+
+		if ( 0 > (idxs[lvl] = _cli$tbl_find(arrs[lvl], cp, len)) )
+			return	$LOG(STS$K_ERROR, "No verb '%.*s' in path '%s'", len, cp, path);
+
+		arrs[lvl + 1] = arrs[lvl][idxs[lvl]].next;
+		lvl++;
+		cp += len;
+		}
+
+	*depth = lvl;
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: replace an array at the given depth by the new one, copy all arrays
+ *		on the path up to root, publish new root and reclaim replaced arrays after a grace period.
+ *		Is supposed to be called under the writer's lock.
+ *
+ *  INPUT:
+ *	tbl:	a command table
+ *	arrs:	arrays on the path, arrs[0] is a root
+ *	idxs:	an index of the verb in the corresponding array
+ *	depth:	an index of the array to be replaced in the 'arrs'
+ *	nverbs:	a new array, NULL - to remove a reference from the upper level verb,
+ *		it's released on failure
+ *	retired:a list of blocks to be reclaimed additionally, they are given back to the table
+ *		on failure
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$tbl_publish	(
+		CLI_TABLE	*tbl,
+		CLI_VERB	**arrs,
+			int	*idxs,
+			int	depth,
+		CLI_VERB	*nverbs,
+		CLI_TBLBLK	*retired
+			)
+{
+CLI_VERB	*copy;
+CLI_TBLBLK	*blk;
+int	lvl, count;
+
+	_cli$tbl_retire(tbl, arrs[depth], &retired);
+
+	for ( lvl = depth - 1; lvl >= 0; lvl--)
+		{
+		count = _cli$tbl_count(arrs[lvl]);
+
+		if ( !(copy = _cli$tbl_alloc(tbl, (count + 1) * sizeof(CLI_VERB))) )
+			{
+			/* Release new copies (every copy refers the previous one) and give retired blocks back */
+			for ( lvl++; nverbs && (lvl <= depth); lvl++)
+				{
+				copy = (lvl < depth) ? nverbs[idxs[lvl]].next : NULL;
+				_cli$tbl_unalloc(tbl, nverbs);
+				nverbs = copy;
+				}
+
+			for ( ; (blk = retired); )
+				{
+				retired = blk->next;
+				blk->next = tbl->blks;
+				tbl->blks = blk;
+				}
+
+			return	$LOG(STS$K_ERROR, "Insufficient memory, errno=%d", errno);
+			}
+
+		memcpy(copy, arrs[lvl], count * sizeof(CLI_VERB));
+		copy[idxs[lvl]].next = nverbs;
+
+		_cli$tbl_retire(tbl, arrs[lvl], &retired);
+		nverbs = copy;
+		}
+
+	/* Publish new snapshot of the tree, wait for readers of the old one ... */
+	__atomic_store_n(&tbl->root, nverbs, __ATOMIC_SEQ_CST);
+	__atomic_add_fetch(&tbl->version, 1, __ATOMIC_SEQ_CST);
+	__atomic_add_fetch(&cli$verbs_gen, 1, __ATOMIC_SEQ_CST);
+
+	_cli$tbl_sync(tbl);
+
+	/* ... and release retired arrays */
+	for ( ; (blk = retired); )
+		{
+		retired = blk->next;
+		free(blk->blk);
+		free(blk);
+		}
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: create a runtime-mutable command table, the given verbs tree is used as initial snapshot
+ *		and is never modified by the cli$tbl_* routines.
+ *
+ *  INPUT:
+ *	verbs:	commands' verbs definition structure, null entry terminated
+ *
+ *  OUTPUT:
+ *	tbl:	A command table to be created
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$tbl_init	(
+		CLI_TABLE	**tbl,
+		CLI_VERB	*verbs
+			)
+{
+	if ( !(*tbl = calloc(1, sizeof(CLI_TABLE))) )
+		return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+
+	if ( !verbs && !(verbs = _cli$tbl_alloc(*tbl, sizeof(CLI_VERB))) )
+		{
+		free(*tbl);
+		return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+		}
+
+	(*tbl)->root = verbs;
+	pthread_mutex_init(&(*tbl)->lock, NULL);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: release a command table and all arrays has been allocated by the table,
+ *		caller must ensure that there is no readers of the table.
+ *
+ *  INPUT:
+ *	tbl:	A command table has been created by cli$tbl_init()
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$tbl_free	(
+		CLI_TABLE	*tbl
+			)
+{
+CLI_TBLBLK	*blk;
+
+	/* Arrays are released, their addresses can be reused */
+	__atomic_add_fetch(&cli$verbs_gen, 1, __ATOMIC_SEQ_CST);
+
+	for ( ; (blk = tbl->blks); )
+		{
+		tbl->blks = blk->next;
+		free(blk->blk);
+		free(blk);
+		}
+
+	pthread_mutex_destroy(&tbl->lock);
+	free(tbl);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: get a current snapshot of the verbs tree to be passed to cli$parse(), the snapshot
+ *		is guaranteed to be valid until cli$tbl_leave().
+ *
+ *  INPUT:
+ *	tbl:	A command table has been created by cli$tbl_init()
+ *
+ *  OUTPUT:
+ *	slot:	a reader's slot to be passed to the cli$tbl_leave()
+ *
+ *  RETURN:
+ *	an address of the verbs tree
+ *
+ */
+CLI_VERB *cli$tbl_enter	(
+		CLI_TABLE	*tbl,
+			int	*slot
+			)
+{
+unsigned	epoch;
+
+	for ( ;; )
+		{
+		epoch = __atomic_load_n(&tbl->epoch, __ATOMIC_SEQ_CST);
+		__atomic_add_fetch(&tbl->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+
+		/* Has a writer flipped an epoch under our feet ? */
+		if ( epoch == __atomic_load_n(&tbl->epoch, __ATOMIC_SEQ_CST) )
+			break;
+
+		__atomic_sub_fetch(&tbl->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+		}
+
+	*slot = epoch & 1;
+
+	return	__atomic_load_n(&tbl->root, __ATOMIC_SEQ_CST);
+}
+
+void	cli$tbl_leave	(
+		CLI_TABLE	*tbl,
+			int	slot
+			)
+{
+	__atomic_sub_fetch(&tbl->readers[slot & 1], 1, __ATOMIC_SEQ_CST);
+}
+
+unsigned cli$tbl_version(
+		CLI_TABLE	*tbl
+			)
+{
+	return	__atomic_load_n(&tbl->version, __ATOMIC_SEQ_CST);
+}
+
+/*
+ *
+ *  DESCRIPTION: register a new verb (or subverb) in the command table.
+ *
+ *  INPUT:
+ *	tbl:	A command table has been created by cli$tbl_init()
+ *	path:	a path to the upper level verb, empty string - the root level
+ *	verb:	a verb's definition to be inserted, it's copied into the table by value,
+ *		subverbs, parameters and qualifiers arrays are still owned by caller
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$tbl_add_verb(
+		CLI_TABLE	*tbl,
+			char	*path,
+		CLI_VERB	*verb
+			)
+{
+CLI_VERB	*arrs[CLI$S_MAXDEPTH + 1], *nverbs;
+int	idxs[CLI$S_MAXDEPTH], depth, count, status;
+
+	pthread_mutex_lock(&tbl->lock);
+
+	if ( !(1 & (status = _cli$tbl_path(tbl->root, path, arrs, idxs, &depth))) )
+		goto	unlock;
+
+	if ( 0 <= _cli$tbl_find(arrs[depth], $ASCPTR(&verb->name), $ASCLEN(&verb->name)) )
+		{
+		status = $LOG(STS$K_ERROR, "Verb '%.*s' is already present in '%s'", $ASC(&verb->name), path);
+		goto	unlock;
+		}
+
+	count = _cli$tbl_count(arrs[depth]);
+
+	if ( !(nverbs = _cli$tbl_alloc(tbl, (count + 2) * sizeof(CLI_VERB))) )
+		{
+		status = $LOG(STS$K_ERROR, "Insufficient memory, errno=%d", errno);
+		goto	unlock;
+		}
+
+	if ( count )
+		memcpy(nverbs, arrs[depth], count * sizeof(CLI_VERB));
+	nverbs[count] = *verb;
+
+	status = _cli$tbl_publish(tbl, arrs, idxs, depth, nverbs, NULL);
+
+unlock:
+	pthread_mutex_unlock(&tbl->lock);
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: unregister a verb (or subverb) and all its subverbs from the command table.
+ *
+ *  INPUT:
+ *	tbl:	A command table has been created by cli$tbl_init()
+ *	path:	a path to the verb to be removed
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$tbl_del_verb(
+		CLI_TABLE	*tbl,
+			char	*path
+			)
+{
+CLI_VERB	*arrs[CLI$S_MAXDEPTH + 1], *nverbs = NULL;
+CLI_TBLBLK	*retired = NULL;
+int	idxs[CLI$S_MAXDEPTH], depth, count, status;
+
+	pthread_mutex_lock(&tbl->lock);
+
+	if ( !(1 & (status = _cli$tbl_path(tbl->root, path, arrs, idxs, &depth))) )
+		goto	unlock;
+
+	if ( !depth )
+		{
+		status = $LOG(STS$K_ERROR, "Root table cannot be removed");
+		goto	unlock;
+		}
+
+	count = _cli$tbl_count(arrs[--depth]);
+
+	/* An empty subverbs table is replaced by NULL, the root level is always present */
+	if ( (count > 1) || !depth )
+		{
+		if ( !(nverbs = _cli$tbl_alloc(tbl, count * sizeof(CLI_VERB))) )
+			{
+			status = $LOG(STS$K_ERROR, "Insufficient memory, errno=%d", errno);
+			goto	unlock;
+			}
+
+		memcpy(nverbs, arrs[depth], idxs[depth] * sizeof(CLI_VERB));
+		memcpy(nverbs + idxs[depth], arrs[depth] + idxs[depth] + 1, (count - idxs[depth] - 1) * sizeof(CLI_VERB));
+		}
+
+	/* Subverbs, parameters and qualifiers arrays of the verb are reclaimed with the parent array */
+	_cli$tbl_retire_verb(tbl, &arrs[depth][idxs[depth]], &retired);
+
+	status = _cli$tbl_publish(tbl, arrs, idxs, depth, nverbs, retired);
+
+unlock:
+	pthread_mutex_unlock(&tbl->lock);
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: replace a qualifiers list of the verb, a list of the verbs containing the verb is copied.
+ *
+ *  INPUT:
+ *	tbl:	A command table has been created by cli$tbl_init()
+ *	arrs:	arrays on the path, arrs[0] is a root
+ *	idxs:	an index of the verb in the corresponding array
+ *	depth:	a number of resolved verbs
+ *	quals:	a new qualifiers list, it's released on failure
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+static	int	_cli$tbl_set_quals	(
+		CLI_TABLE	*tbl,
+		CLI_VERB	**arrs,
+			int	*idxs,
+			int	depth,
+		CLI_PQDESC	*quals
+			)
+{
+CLI_VERB	*nverbs;
+CLI_TBLBLK	*retired = NULL;
+int	count, status;
+
+	count = _cli$tbl_count(arrs[--depth]);
+
+	if ( !(nverbs = _cli$tbl_alloc(tbl, (count + 1) * sizeof(CLI_VERB))) )
+		{
+		_cli$tbl_unalloc(tbl, quals);
+		return	$LOG(STS$K_ERROR, "Insufficient memory, errno=%d", errno);
+		}
+
+	memcpy(nverbs, arrs[depth], count * sizeof(CLI_VERB));
+
+	_cli$tbl_retire(tbl, nverbs[idxs[depth]].quals, &retired);
+	nverbs[idxs[depth]].quals = quals;
+
+	if ( !(1 & (status = _cli$tbl_publish(tbl, arrs, idxs, depth, nverbs, retired))) )
+		_cli$tbl_unalloc(tbl, quals);
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: register a new qualifier for the verb.
+ *
+ *  INPUT:
+ *	tbl:	A command table has been created by cli$tbl_init()
+ *	path:	a path to the verb
+ *	qual:	a qualifier's definition, it's copied into the table by value
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$tbl_add_qual(
+		CLI_TABLE	*tbl,
+			char	*path,
+		CLI_PQDESC	*qual
+			)
+{
+CLI_VERB	*arrs[CLI$S_MAXDEPTH + 1], *verb;
+CLI_PQDESC	*quals, *qrun;
+int	idxs[CLI$S_MAXDEPTH], depth, count = 0, status;
+
+	pthread_mutex_lock(&tbl->lock);
+
+	if ( !(1 & (status = _cli$tbl_path(tbl->root, path, arrs, idxs, &depth))) )
+		goto	unlock;
+
+	if ( !depth )
+		{
+		status = $LOG(STS$K_ERROR, "Qualifiers cannot be added to the root table");
+		goto	unlock;
+		}
+
+	verb = &arrs[depth - 1][idxs[depth - 1]];
+
+	for ( qrun = verb->quals; qrun && $ASCLEN(&qrun->name); qrun++, count++)
+		{
+		if ( ($ASCLEN(&qrun->name) == $ASCLEN(&qual->name))
+			&& !strncasecmp($ASCPTR(&qrun->name), $ASCPTR(&qual->name), $ASCLEN(&qual->name)) )
+			{
+			status = $LOG(STS$K_ERROR, "Qualifier '%.*s' is already present in '%s'", $ASC(&qual->name), path);
+			goto	unlock;
+			}
+		}
+
+	if ( !(quals = _cli$tbl_alloc(tbl, (count + 2) * sizeof(CLI_PQDESC))) )
+		{
+		status = $LOG(STS$K_ERROR, "Insufficient memory, errno=%d", errno);
+		goto	unlock;
+		}
+
+	if ( count )
+		memcpy(quals, verb->quals, count * sizeof(CLI_PQDESC));
+	quals[count] = *qual;
+
+	status = _cli$tbl_set_quals(tbl, arrs, idxs, depth, quals);
+
+unlock:
+	pthread_mutex_unlock(&tbl->lock);
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: unregister a qualifier of the verb.
+ *
+ *  INPUT:
+ *	tbl:	A command table has been created by cli$tbl_init()
+ *	path:	a path to the verb
+ *	qual:	a full name of the qualifier to be removed
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$tbl_del_qual(
+		CLI_TABLE	*tbl,
+			char	*path,
+			char	*qual
+			)
+{
+CLI_VERB	*arrs[CLI$S_MAXDEPTH + 1], *verb;
+CLI_PQDESC	*quals, *qrun;
+int	idxs[CLI$S_MAXDEPTH], depth, count = 0, qidx = -1, len, status;
+
+	pthread_mutex_lock(&tbl->lock);
+
+	if ( !(1 & (status = _cli$tbl_path(tbl->root, path, arrs, idxs, &depth))) )
+		goto	unlock;
+
+	if ( !depth )
+		{
+		status = $LOG(STS$K_ERROR, "Qualifiers cannot be removed from the root table");
+		goto	unlock;
+		}
+
+	verb = &arrs[depth - 1][idxs[depth - 1]];
+	len = strnlen(qual, ASC$K_SZ);
+
+	for ( qrun = verb->quals; qrun && $ASCLEN(&qrun->name); qrun++, count++)
+		if ( (len == $ASCLEN(&qrun->name)) && !strncasecmp($ASCPTR(&qrun->name), qual, len) )
+			qidx = count;
+
+	if ( 0 > qidx )
+		{
+		status = $LOG(STS$K_ERROR, "No qualifier '%s' in '%s'", qual, path);
+		goto	unlock;
+		}
+
+	/* Allocate new list, it's always null entry terminated */
+	if ( !(quals = _cli$tbl_alloc(tbl, count * sizeof(CLI_PQDESC))) )
+		{
+		status = $LOG(STS$K_ERROR, "Insufficient memory, errno=%d", errno);
+		goto	unlock;
+		}
+
+	memcpy(quals, verb->quals, qidx * sizeof(CLI_PQDESC));
+	memcpy(quals + qidx, verb->quals + qidx + 1, (count - qidx - 1) * sizeof(CLI_PQDESC));
+
+	status = _cli$tbl_set_quals(tbl, arrs, idxs, depth, quals);
+
+unlock:
+	pthread_mutex_unlock(&tbl->lock);
+
+	return	status;
+}
+
+
+
+/*
+ * Incremental parser's session stuff
+ */
+typedef struct __cli_sestok__ {
+	ASC		val;	/* A token's text has been seen last time	*/
+	CLI_TOKSTAT	stat;	/* A result of matching and checking		*/
+
+	CLI_VERB	*verbs,	/* Parser's state after the token:		*/
+			*verb;	/* a table for next verb or a completed verb,	*/
+	CLI_PQDESC	*param;	/* a next expected parameter			*/
+} CLI_SESTOK;
+
+struct __cli_session__ {
+	CLI_CTX		ctx;	/* Processing options for matching and checking	*/
+	CLI_VERB	*verbs;	/* Commands' verbs definition structure		*/
+
+	int		ntoks,	/* Tokens in the last command line		*/
+			maxtoks;/* Allocated entries in 'toks'			*/
+	CLI_SESTOK	*toks;
+};
+
+/*
+ *
+ *  DESCRIPTION: match a single token in the given parser's state, check a value of the parameter or qualifier,
+ *		advance the parser's state.
+ *
+ *  INPUT:
+ *	ses:	A parser's session
+ *	tok:	A token to be matched
+ *	old:	A previous result for the same token's text, NULL - text has been changed
+ *	verbs:	A table for the next verb
+ *	verb:	A completed verb
+ *	param:	A next expected parameter
+ *
+ *  IMPLICIT OUTPUT:
+ *	tok->stat, verbs, verb, param
+ *
+ */
+static	void	_cli$ses_match	(
+	CLI_SESSION	*ses,
+	CLI_SESTOK	*tok,
+	CLI_TOKSTAT	*old,
+	CLI_VERB	**verbs,
+	CLI_VERB	**verb,
+	CLI_PQDESC	**param
+			)
+{
+CLI_VERB	*vsel;
+CLI_PQDESC	*pqdesc;
+ASC		val = {0};
+char		*aptr = $ASCPTR(&tok->val), *vptr;
+int		len = $ASCLEN(&tok->val), status;
+
+	memset(&tok->stat, 0, sizeof(CLI_TOKSTAT));
+
+	/* Is a verb (or subverb) expected ? */
+	if ( *verbs )
+		{
+		status = _cli$match_verb(&ses->ctx, *verbs, aptr, $MIN(len, CLI$S_MAXVERBL), &vsel);
+
+		if ( (1 & status) )
+			status = _cli$bind_verb(&ses->ctx, &vsel);
+
+		*verbs = NULL;
+
+		if ( !((tok->stat.sts = status) & 1) )
+			return;
+
+		tok->stat.verb = vsel;
+
+		if ( vsel->next )
+			*verbs = vsel->next;
+		else	{
+			*verb = vsel;
+			*param = vsel->params;
+			}
+
+		return;
+		}
+
+	/* Positional parameters are going first ... */
+	if ( *verb && *param && (*param)->pn )
+		{
+		pqdesc = (*param)++;
+		tok->stat.type = pqdesc->pn;
+		val = tok->val;
+		}
+	/* ... then qualifiers */
+	else if ( *verb && len && ((*aptr == '/') || (*aptr == '-')) )
+		{
+		aptr++;
+		len--;
+
+		tok->stat.type = CLI$K_QUAL;
+		ses->ctx.tokoff = 1;
+
+		if ( vptr = memchr(aptr, '=', len) )
+			{
+			vptr++;
+			val.len = len - (vptr - aptr);
+			memcpy(val.sts, vptr, val.len);
+			len = vptr - aptr - 1;
+			}
+
+		if ( !((tok->stat.sts = _cli$match_qual(&ses->ctx, (*verb)->quals, aptr, len, &pqdesc)) & 1) )
+			return;
+		}
+	else	{
+		tok->stat.type = CLI$K_EXTRA;
+		tok->stat.sts = STS$K_WARN;
+		return;
+		}
+
+	tok->stat.pqdesc = pqdesc;
+
+	/* Re-validate only if a text or a definition of the parameter/qualifier has been changed */
+	if ( old && (old->type == tok->stat.type) && (old->pqdesc == pqdesc) )
+		{
+		tok->stat.sts = old->sts;
+		return;
+		}
+
+	ses->ctx.tokoff += (tok->stat.type == CLI$K_QUAL) ? len + 1 : 0;
+
+	tok->stat.sts = $ASCLEN(&val) ? cli$val_check(&ses->ctx, pqdesc, &val) : STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: create an incremental parser's session.
+ *
+ *  INPUT:
+ *	verbs:	commands' verbs definition structure, null entry terminated
+ *	opts:	processing options, see CLI$M_OP*
+ *
+ *  OUTPUT:
+ *	ses:	A parser's session to be created
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$ses_init	(
+	CLI_SESSION	**ses,
+	CLI_VERB	*verbs,
+		int	opts
+			)
+{
+	if ( !(*ses = calloc(1, sizeof(CLI_SESSION))) )
+		return	(opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno) : STS$K_FATAL;
+
+	(*ses)->ctx.opts = opts;
+	(*ses)->verbs = verbs;
+
+	return	STS$K_SUCCESS;
+}
+
+int	cli$ses_free	(
+	CLI_SESSION	*ses
+			)
+{
+	free(ses->toks);
+	free(ses);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: parse an edited command line, tokens before a first changed token are kept as is,
+ *		the rest tokens are re-matched, values are re-checked only for changed tokens or if a token
+ *		has been matched to other parameter/qualifier.
+ *
+ *  INPUT:
+ *	ses:	A parser's session has been created by cli$ses_init()
+ *	argc:	arguments count
+ *	argv:	arguments array
+ *
+ *  OUTPUT:
+ *	first:	an index of the first re-matched token, argc - nothing has been changed
+ *
+ *  RETURN:
+ *	SS$_NORMAL	- all tokens are legal and the command is complete,
+ *	STS$K_WARN	- the command is not complete or there are unexpected tokens,
+ *	condition status of the first failed token
+ *
+ */
+int	cli$ses_update	(
+	CLI_SESSION	*ses,
+		int	argc,
+		char **	argv,
+		int	*first
+			)
+{
+CLI_SESTOK	*tok, *toks;
+CLI_TOKSTAT	old;
+CLI_VERB	*verbs, *verb;
+CLI_PQDESC	*param;
+int		i, len, same, status;
+
+	ses->ctx.argc = argc;
+	ses->ctx.argv = argv;
+
+	if ( argc && !(1 & (status = _cli$check_limits(&ses->ctx, argc, argv))) )
+		return	status;
+
+	if ( argc > ses->maxtoks )
+		{
+		if ( !(toks = realloc(ses->toks, argc * sizeof(CLI_SESTOK))) )
+			return	(ses->ctx.opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno) : STS$K_FATAL;
+
+		memset(toks + ses->maxtoks, 0, (argc - ses->maxtoks) * sizeof(CLI_SESTOK));
+		ses->toks = toks;
+		ses->maxtoks = argc;
+		}
+
+	/* Find a first changed token */
+	for ( i = 0; (i < argc) && (i < ses->ntoks); i++ )
+		{
+		len = strnlen(argv[i], ASC$K_SZ);
+
+		if ( (len != $ASCLEN(&ses->toks[i].val)) || memcmp(argv[i], $ASCPTR(&ses->toks[i].val), len) )
+			break;
+		}
+
+	*first = i;
+
+	/* Restore the parser's state before the token */
+	if ( i )
+		{
+		verbs = ses->toks[i - 1].verbs;
+		verb = ses->toks[i - 1].verb;
+		param = ses->toks[i - 1].param;
+		}
+	else	{
+		verbs = ses->verbs;
+		verb = NULL;
+		param = NULL;
+		}
+
+	for ( ; i < argc; i++ )
+		{
+		tok = &ses->toks[i];
+		len = strnlen(argv[i], ASC$K_SZ);
+		old = tok->stat;
+
+		if ( !(same = (i < ses->ntoks) && (len == $ASCLEN(&tok->val)) && !memcmp(argv[i], $ASCPTR(&tok->val), len)) )
+			{
+			memset(&tok->val, 0, sizeof(ASC));
+			__util$str2asc(argv[i], &tok->val);
+			}
+
+		ses->ctx.tokidx = i;
+		ses->ctx.tokoff = 0;
+
+		_cli$ses_match(ses, tok, same ? &old : NULL, &verbs, &verb, &param);
+
+		tok->verbs = verbs;
+		tok->verb = verb;
+		tok->param = param;
+		}
+
+	ses->ntoks = argc;
+
+	/* Report a first failed token */
+	for ( i = 0, status = STS$K_SUCCESS; i < argc; i++ )
+		{
+		if ( !(1 & ses->toks[i].stat.sts) )
+			return	ses->toks[i].stat.sts;
+		}
+
+	/* Is the command complete ? */
+	if ( !argc || verbs || (param && param->pn) )
+		return	STS$K_WARN;
+
+	return	status;
+}
+
+/*
+ *
+ *  DESCRIPTION: retrieve a result of matching and checking of the token.
+ *
+ *  INPUT:
+ *	ses:	A parser's session has been created by cli$ses_init()
+ *	idx:	an index of the token
+ *
+ *  OUTPUT:
+ *	tok:	a buffer to accept the token's status
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$ses_token	(
+	CLI_SESSION	*ses,
+		int	idx,
+	CLI_TOKSTAT	*tok
+			)
+{
+	if ( (idx < 0) || (idx >= ses->ntoks) )
+		return	(ses->ctx.opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_ERROR, "Illegal token index %d", idx) : STS$K_ERROR;
+
+	*tok = ses->toks[idx].stat;
+
+	return	STS$K_SUCCESS;
+}
+
+
+
+/*
+ * Command text lexer stuff: a kernel classifies 64 octets block into bitmasks of white spaces
+ * and quotes, tokens are built by scanning of the bitmasks.
+ */
+#define	CLI$S_LEXBLK	64
+
+typedef struct __cli_lexblk__ {
+	unsigned long long	ws,	/* Space, TAB, CR, LF		*/
+				quote;	/* '"'				*/
+} CLI_LEXBLK;
+
+static	void	_cli$lex_scalar	(
+		const char	*buf,
+		CLI_LEXBLK	*blk
+			)
+{
+int	i;
+
+	memset(blk, 0, sizeof(CLI_LEXBLK));
+
+	for ( i = 0; i < CLI$S_LEXBLK; i++ )
+		switch ( buf[i] )
+			{
+			case	' ':
+			case	'\t':
+			case	'\r':
+			case	'\n':	blk->ws |= 1ULL << i; break;
+			case	'"':	blk->quote |= 1ULL << i; break;
+			}
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse2")))
+static	void	_cli$lex_sse2	(
+		const char	*buf,
+		CLI_LEXBLK	*blk
+			)
+{
+__m128i	v;
+unsigned long long m;
+int	i;
+
+	memset(blk, 0, sizeof(CLI_LEXBLK));
+
+	for ( i = 0; i < CLI$S_LEXBLK; i += 16 )
+		{
+		v = _mm_loadu_si128((const __m128i *) (buf + i));
+
+		m = (unsigned) _mm_movemask_epi8(_mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+				_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')))));
+		blk->ws |= m << i;
+
+		m = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+		blk->quote |= m << i;
+		}
+}
+
+__attribute__((target("avx2")))
+static	void	_cli$lex_avx2	(
+		const char	*buf,
+		CLI_LEXBLK	*blk
+			)
+{
+__m256i	v;
+unsigned long long m;
+int	i;
+
+	memset(blk, 0, sizeof(CLI_LEXBLK));
+
+	for ( i = 0; i < CLI$S_LEXBLK; i += 32 )
+		{
+		v = _mm256_loadu_si256((const __m256i *) (buf + i));
+
+		m = (unsigned) _mm256_movemask_epi8(_mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')))));
+		blk->ws |= m << i;
+
+		m = (unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+		blk->quote |= m << i;
+		}
+}
+
+#endif	/* __x86_64__ || __i386__ */
+
+typedef	void	(*CLI_LEXKRNL) (const char *buf, CLI_LEXBLK *blk);
+
+static	CLI_LEXKRNL	cli$lex_kernel;
+
+/*
+ *
+ *  DESCRIPTION: select a lexer's kernel corresponding to the CPU features, it's resolved once.
+ *
+ *  RETURN:
+ *	an address of the kernel routine
+ *
+ */
+static	CLI_LEXKRNL	_cli$lex_kernel	(void)
+{
+CLI_LEXKRNL	krnl;
+
+	if ( (krnl = __atomic_load_n(&cli$lex_kernel, __ATOMIC_ACQUIRE)) )
+		return	krnl;
+
+	krnl = _cli$lex_scalar;
+
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+
+	if ( __builtin_cpu_supports("avx2") )
+		krnl = _cli$lex_avx2;
+	else if ( __builtin_cpu_supports("sse2") )
+		krnl = _cli$lex_sse2;
+#endif
+
+	__atomic_store_n(&cli$lex_kernel, krnl, __ATOMIC_RELEASE);
+
+	return	krnl;
+}
+
+/*
+ *
+ *  DESCRIPTION: force a lexer's kernel, e.g. to compare kernels' outputs or performance.
+ *
+ *  INPUT:
+ *	kind:	CLI$K_LEX_*, CLI$K_LEX_AUTO - the best kernel supported by the CPU
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$lex_set_kernel	(
+		int	kind
+			)
+{
+CLI_LEXKRNL	krnl = NULL;
+
+	switch ( kind )
+		{
+		case	CLI$K_LEX_AUTO:
+			break;
+
+		case	CLI$K_LEX_SCALAR:
+			krnl = _cli$lex_scalar;
+			break;
+
+#if defined(__x86_64__) || defined(__i386__)
+		case	CLI$K_LEX_SSE2:
+			__builtin_cpu_init();
+
+			if ( __builtin_cpu_supports("sse2") )
+				krnl = _cli$lex_sse2;
+			break;
+
+		case	CLI$K_LEX_AVX2:
+			__builtin_cpu_init();
+
+			if ( __builtin_cpu_supports("avx2") )
+				krnl = _cli$lex_avx2;
+			break;
+#endif
+		}
+
+	if ( (kind != CLI$K_LEX_AUTO) && !krnl )
+		return	$LOG(STS$K_ERROR, "Lexer's kernel %d is not supported", kind);
+
+	__atomic_store_n(&cli$lex_kernel, krnl, __ATOMIC_RELEASE);
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: split a command text into tokens.
+ *
+ *  INPUT:
+ *	buf:	a command text
+ *	len:	a length of the text
+ *	toks:	an array to accept tokens
+ *	maxtoks:a size of the array
+ *
+ *  RETURN:
+ *	a number of tokens, it can be more than 'maxtoks' - the rest is not stored
+ *
+ */
+int	cli$lex		(
+		char	*buf,
+		int	len,
+	CLI_TOKEN	*toks,
+		int	maxtoks
+			)
+{
+CLI_LEXKRNL	krnl = _cli$lex_kernel();
+CLI_LEXBLK	blk;
+char		tmp[CLI$S_LEXBLK];
+unsigned long long inq, ws, starts, ends, events, bit, prevws = 1, inquote = 0;
+int		base, n, pos, off = 0, intok = 0, ntoks = 0;
+
+	for ( base = 0; base < len; base += CLI$S_LEXBLK )
+		{
+		/* The tail is padded by spaces */
+		if ( CLI$S_LEXBLK <= (n = len - base) )
+			krnl(buf + base, &blk);
+		else	{
+			memset(tmp, ' ', sizeof(tmp));
+			memcpy(tmp, buf + base, n);
+			krnl(tmp, &blk);
+			}
+
+		/* A mask of quoted text: prefix XOR of quotes, carry the state from previous block */
+		inq = blk.quote;
+		inq ^= inq << 1;
+		inq ^= inq << 2;
+		inq ^= inq << 4;
+		inq ^= inq << 8;
+		inq ^= inq << 16;
+		inq ^= inq << 32;
+		inq ^= 0ULL - inquote;
+		inquote = inq >> 63;
+
+		ws = blk.ws & ~inq;
+		starts = ~ws & ((ws << 1) | prevws);
+		ends = ws & ((~ws << 1) | (prevws ^ 1));
+		prevws = ws >> 63;
+
+		/* Walk over token's boundaries in order */
+		for ( events = starts | ends; events; events &= events - 1 )
+			{
+			pos = __builtin_ctzll(events);
+			bit = 1ULL << pos;
+
+			if ( starts & bit )
+				{
+				off = base + pos;
+				intok = 1;
+				continue;
+				}
+
+			if ( ntoks < maxtoks )
+				toks[ntoks].off = off, toks[ntoks].len = base + pos - off;
+			ntoks++;
+			intok = 0;
+			}
+		}
+
+	/* A token is running up to end of text */
+	if ( intok )
+		{
+		if ( ntoks < maxtoks )
+			toks[ntoks].off = off, toks[ntoks].len = len - off;
+		ntoks++;
+		}
+
+	return	ntoks;
+}
+
+
+/*
+ * Dry-run validation stuff
+ */
+typedef struct __cli_valchunk__ {
+	CLI_VERB	*verbs;		/* Commands' verbs definition structure	*/
+	int		opts;		/* Processing options, see CLI$M_OP*	*/
+
+	char		*beg,		/* A part of the script: [beg, end)	*/
+			*end;
+
+	unsigned long long nlines;	/* Lines in the chunk			*/
+
+	int		nerrs,		/* Errors has been found in the chunk	*/
+			maxerrs;
+	CLI_VALERR	*errs;
+
+	int		status;		/* Condition status of the worker	*/
+	pthread_t	tid;
+} CLI_VALCHUNK;
+
+/*
+ *
+ *  DESCRIPTION: a worker to validate a chunk of the script, errors are collected with line numbers
+ *		relative to the chunk.
+ *
+ *  INPUT:
+ *	arg:	a chunk's descriptor, CLI_VALCHUNK
+ *
+ *  RETURN:
+ *	NULL
+ *
+ */
+static	void	*_cli$validate_chunk	(
+			void	*arg
+			)
+{
+CLI_VALCHUNK	*chunk = arg;
+CLI_VALERR	*errs;
+CLI_CTX		*ctx = NULL;
+CLI_TOKEN	*toks = NULL, *ntoks;
+char		*lp, *ep, *line = NULL, **argv = NULL, **nargv;
+int		i, len, linesz = 0, argc, maxargs = 0, status;
+
+	chunk->status = STS$K_SUCCESS;
+
+	for ( lp = chunk->beg; lp < chunk->end; lp = ep + 1)
+		{
+		if ( !(ep = memchr(lp, '\n', chunk->end - lp)) )
+			ep = chunk->end;
+
+		chunk->nlines++;
+
+		for ( len = ep - lp; len && (lp[len - 1] == '\r'); len--);
+
+		/* Make a NUL terminated copy of the line to be split */
+		if ( len >= linesz )
+			{
+			free(line);
+			linesz = $MAX(len + 1, 2 * linesz);
+
+			if ( !(line = malloc(linesz)) )
+				{
+				chunk->status = STS$K_FATAL;
+				break;
+				}
+			}
+
+		memcpy(line, lp, len);
+
+		/* Split and skip empty lines and comments */
+		while ( maxargs < (argc = cli$lex(line, len, toks, maxargs)) )
+			{
+			if ( !(nargv = realloc(argv, argc * sizeof(char *))) )
+				{
+				chunk->status = STS$K_FATAL;
+				break;
+				}
+
+			argv = nargv;
+
+			if ( !(ntoks = realloc(toks, argc * sizeof(CLI_TOKEN))) )
+				{
+				chunk->status = STS$K_FATAL;
+				break;
+				}
+
+			toks = ntoks;
+			maxargs = argc;
+			}
+
+		if ( !(1 & chunk->status) )
+			break;
+
+		if ( !argc || (line[toks[0].off] == '!') )
+			continue;
+
+		for ( i = 0; i < argc; i++ )
+			{
+			argv[i] = line + toks[i].off;
+			argv[i][toks[i].len] = '\0';
+			}
+
+		status = cli$parse(chunk->verbs, chunk->opts, argc, argv, (void **) &ctx);
+
+		if ( !ctx )
+			{
+			chunk->status = status;
+			break;
+			}
+
+		if ( !(1 & status) )
+			{
+			if ( chunk->nerrs == chunk->maxerrs )
+				{
+				chunk->maxerrs = $MAX(32, 2 * chunk->maxerrs);
+
+				if ( !(errs = realloc(chunk->errs, chunk->maxerrs * sizeof(CLI_VALERR))) )
+					{
+					chunk->status = STS$K_FATAL;
+					cli$cleanup(ctx);
+					break;
+					}
+
+				chunk->errs = errs;
+				}
+
+			chunk->errs[chunk->nerrs].lineno = chunk->nlines;
+			chunk->errs[chunk->nerrs].err = ctx->err;
+			chunk->nerrs++;
+			}
+
+		cli$cleanup(ctx);
+		}
+
+	free(line);
+	free(argv);
+	free(toks);
+
+	return	NULL;
+}
+
+/*
+ *
+ *  DESCRIPTION: validate a command script without dispatching: the file is mapped into memory, split into
+ *		chunks at line boundaries, chunks are parsed and checked in parallel.
+ *
+ *  INPUT:
+ *	verbs:	commands' verbs definition structure, null entry terminated
+ *	opts:	processing options, see CLI$M_OP*, CLI$M_OPSIGNAL is ignored
+ *	fspec:	a script file specification
+ *	nthreads: a number of threads, 0 - a number of online CPUs
+ *
+ *  OUTPUT:
+ *	errs:	an array of errors in line order, should be released by free()
+ *	nerrs:	a number of errors
+ *
+ *  RETURN:
+ *	SS$_NORMAL	- the script has been validated, see 'nerrs'
+ *	condition status
+ *
+ */
+int	cli$validate_file	(
+	CLI_VERB	*verbs,
+		int	opts,
+		char	*fspec,
+		int	nthreads,
+	CLI_VALERR	**errs,
+		int	*nerrs
+			)
+{
+CLI_VALCHUNK	*chunks;
+struct stat	st;
+char		*base, *cp;
+unsigned long long nlines;
+int		fd, i, j, status = STS$K_SUCCESS;
+
+	*errs = NULL;
+	*nerrs = 0;
+
+	if ( 0 > (fd = open(fspec, O_RDONLY)) )
+		return	$LOG(STS$K_ERROR, "open(%s), errno=%d", fspec, errno);
+
+	if ( fstat(fd, &st) )
+		{
+		close(fd);
+		return	$LOG(STS$K_ERROR, "fstat(%s), errno=%d", fspec, errno);
+		}
+
+	if ( !st.st_size )
+		{
+		close(fd);
+		return	STS$K_SUCCESS;
+		}
+
+	base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if ( base == MAP_FAILED )
+		return	$LOG(STS$K_ERROR, "mmap(%s), errno=%d", fspec, errno);
+
+	madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+	if ( nthreads <= 0 )
+		nthreads = $MAX(1, sysconf(_SC_NPROCESSORS_ONLN));
+
+	/* Don't split into tiny chunks */
+	nthreads = $MAX(1, $MIN(nthreads, st.st_size / 4096 + 1));
+
+	if ( !(chunks = calloc(nthreads, sizeof(CLI_VALCHUNK))) )
+		{
+		munmap(base, st.st_size);
+		return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+		}
+
+	/* Split the script at line boundaries */
+	for ( i = 0, cp = base; i < nthreads; i++)
+		{
+		chunks[i].verbs = verbs;
+		chunks[i].opts = opts & (~CLI$M_OPSIGNAL);
+		chunks[i].beg = cp;
+
+		if ( i == nthreads - 1 )
+			cp = base + st.st_size;
+		else	{
+			cp = $MAX(cp, base + (st.st_size / nthreads) * (i + 1));
+
+			if ( (cp = memchr(cp, '\n', base + st.st_size - cp)) )
+				cp++;
+			else	cp = base + st.st_size;
+			}
+
+		chunks[i].end = cp;
+		}
+
+	/* Run workers, the first chunk is processed by the caller's thread */
+	for ( i = 1; i < nthreads; i++)
+		{
+		if ( pthread_create(&chunks[i].tid, NULL, _cli$validate_chunk, &chunks[i]) )
+			{
+			chunks[i].tid = 0;
+			_cli$validate_chunk(&chunks[i]);
+			}
+		}
+
+	_cli$validate_chunk(&chunks[0]);
+
+	for ( i = 1; i < nthreads; i++)
+		if ( chunks[i].tid )
+			pthread_join(chunks[i].tid, NULL);
+
+	/* Merge errors in line order */
+	for ( i = 0; i < nthreads; i++)
+		{
+		*nerrs += chunks[i].nerrs;
+
+		if ( !(1 & chunks[i].status) )
+			status = chunks[i].status;
+		}
+
+	if ( *nerrs && !(*errs = malloc(*nerrs * sizeof(CLI_VALERR))) )
+		status = $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+
+	for ( i = 0, nlines = 0, *nerrs = 0; i < nthreads; i++)
+		{
+		for ( j = 0; *errs && (j < chunks[i].nerrs); j++, (*nerrs)++)
+			{
+			(*errs)[*nerrs] = chunks[i].errs[j];
+			(*errs)[*nerrs].lineno += nlines;
+			}
+
+		nlines += chunks[i].nlines;
+		free(chunks[i].errs);
+		}
+
+	free(chunks);
+	munmap(base, st.st_size);
+
+	return	status;
+}
+
+/*
+ * Pipelined executor: a slot travels through the rings: PARSE -> VALIDATE -> DISPATCH -> free ring,
+ * every ring has a single producer and a single consumer. A waiting side spins a bit, then parks
+ * on the ring's condition variable, the other side wakes it only if it has been parked.
+ */
+#define	CLI$K_PIPE_SPINS	64
+#define	CLI$K_PIPE_FREE		CLI$K_PIPE_STAGES	/* Ring of the free slots	*/
+
+typedef struct __cli_pipeslot__
+{
+	char		*line,		/* NUL terminated copy of the command	*/
+			**argv;
+	CLI_TOKEN	*toks;
+	int		linesz,
+			maxargs;
+
+	CLI_CTX		*ctx;
+	int		status,
+			eof;		/* Last slot, stages exit		*/
+	void		*arg;		/* Caller's argument of the command	*/
+} CLI_PIPESLOT;
+
+typedef struct __cli_ring__
+{
+	unsigned long long	head __attribute__ ((aligned(64))),	/* Consumer's index	*/
+				tail __attribute__ ((aligned(64)));	/* Producer's index	*/
+
+	int		parked __attribute__ ((aligned(64)));	/* Waiting sides	*/
+	unsigned	mask;
+	CLI_PIPESLOT	**slots;
+
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+} CLI_RING;
+
+typedef struct __cli_pipestg__
+{
+	CLI_PIPE	*pipe;
+	int		stage;
+	pthread_t	tid;
+} CLI_PIPESTG;
+
+struct __cli_pipe__
+{
+	CLI_VERB	*verbs;
+	int		opts,
+			depth;
+	CLI_PIPEAST	ast;
+
+	CLI_RING	rings [CLI$K_PIPE_STAGES + 1];
+	CLI_PIPESLOT	*slots;
+	CLI_PIPESTG	stgs [CLI$K_PIPE_STAGES];
+
+	unsigned long long start;
+	CLI_PIPESTAT	stat;
+};
+
+/* Wait for a condition of the ring: the ring isn't empty (get) or isn't full (put) */
+static	void	_cli$ring_wait	(
+		CLI_RING *ring,
+		int	put
+			)
+{
+int	i;
+
+#define	__RING_READY__	(put ? (__atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST) - __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) <= ring->mask) \
+		: (__atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST) != __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST)))
+
+	for ( i = 0; i < CLI$K_PIPE_SPINS; i++)
+		{
+		if ( __RING_READY__ )
+			return;
+
+		sched_yield();
+		}
+
+	pthread_mutex_lock(&ring->lock);
+	__atomic_add_fetch(&ring->parked, 1, __ATOMIC_SEQ_CST);
+
+	while ( !__RING_READY__ )
+		pthread_cond_wait(&ring->cond, &ring->lock);
+
+	__atomic_sub_fetch(&ring->parked, 1, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&ring->lock);
+
+#undef	__RING_READY__
+}
+
+static	void	_cli$ring_wake	(
+		CLI_RING *ring
+			)
+{
+	if ( !__atomic_load_n(&ring->parked, __ATOMIC_SEQ_CST) )
+		return;
+
+	pthread_mutex_lock(&ring->lock);
+	pthread_cond_broadcast(&ring->cond);
+	pthread_mutex_unlock(&ring->lock);
+}
+
+/* Put a slot into the ring, return a time of waiting for a free entry */
+static	unsigned long long _cli$ring_put	(
+		CLI_RING *ring,
+	CLI_PIPESLOT	*slot
+			)
+{
+unsigned long long tail = ring->tail, t0 = 0;
+
+	if ( tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) > ring->mask )
+		{
+		t0 = _cli$now(CLOCK_MONOTONIC);
+		_cli$ring_wait(ring, 1);
+		t0 = _cli$now(CLOCK_MONOTONIC) - t0;
+		}
+
+	ring->slots[tail & ring->mask] = slot;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_SEQ_CST);
+	_cli$ring_wake(ring);
+
+	return	t0;
+}
+
+/* Get a slot from the ring, return a time of waiting for a slot */
+static	unsigned long long _cli$ring_get	(
+		CLI_RING *ring,
+	CLI_PIPESLOT	**slot
+			)
+{
+unsigned long long head = ring->head, t0 = 0;
+
+	if ( head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) )
+		{
+		t0 = _cli$now(CLOCK_MONOTONIC);
+		_cli$ring_wait(ring, 0);
+		t0 = _cli$now(CLOCK_MONOTONIC) - t0;
+		}
+
+	*slot = ring->slots[head & ring->mask];
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_SEQ_CST);
+	_cli$ring_wake(ring);
+
+	return	t0;
+}
+
+/* Split the line into arguments and parse, values aren't checked */
+static	int	_cli$pipe_parse	(
+		CLI_PIPE *pipe,
+	CLI_PIPESLOT	*slot
+			)
+{
+int	argc, len = strlen(slot->line), i;
+char	**argv;
+CLI_TOKEN *toks;
+
+	while ( slot->maxargs < (argc = cli$lex(slot->line, len, slot->toks, slot->maxargs)) )
+		{
+		if ( !(argv = realloc(slot->argv, argc * sizeof(char *))) )
+			return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+
+		slot->argv = argv;
+
+		if ( !(toks = realloc(slot->toks, argc * sizeof(CLI_TOKEN))) )
+			return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+
+		slot->toks = toks;
+		slot->maxargs = argc;
+		}
+
+	/* Empty lines and comments are passed to the completion routine as is */
+	if ( !argc || (slot->line[slot->toks[0].off] == '!') )
+		return	STS$K_SUCCESS;
+
+	for ( i = 0; i < argc; i++ )
+		{
+		slot->argv[i] = slot->line + slot->toks[i].off;
+		slot->argv[i][slot->toks[i].len] = '\0';
+		}
+
+	return	cli$parse(pipe->verbs, pipe->opts | CLI$M_OPDEFERVAL, argc, slot->argv, (void **) &slot->ctx);
+}
+
+static	void	*_cli$pipe_stage	(
+			void	*arg
+			)
+{
+CLI_PIPESTG	*stg = arg;
+CLI_PIPE	*pipe = stg->pipe;
+CLI_PIPESLOT	*slot;
+unsigned long long t0, idle;
+int		eof;
+
+	do	{
+		idle = _cli$ring_get(&pipe->rings[stg->stage], &slot);
+		t0 = _cli$now(CLOCK_MONOTONIC);
+
+		if ( !(eof = slot->eof) )
+			{
+			switch ( stg->stage )
+				{
+				case	CLI$K_PIPE_PARSE:
+					slot->ctx = NULL;
+
+					if ( 1 & slot->status )
+						slot->status = _cli$pipe_parse(pipe, slot);
+					break;
+
+				case	CLI$K_PIPE_VALIDATE:
+					if ( slot->ctx && (1 & slot->status) )
+						slot->status = cli$validate(slot->ctx);
+					break;
+
+				case	CLI$K_PIPE_DISPATCH:
+					if ( slot->ctx && (1 & slot->status) )
+						slot->status = cli$dispatch(slot->ctx);
+
+					if ( pipe->ast )
+						pipe->ast(slot->ctx, slot->status, slot->arg);
+
+					if ( slot->ctx )
+						cli$cleanup(slot->ctx);
+
+					slot->ctx = NULL;
+					break;
+				}
+
+			__atomic_add_fetch(&pipe->stat.stage[stg->stage].items, 1, __ATOMIC_RELAXED);
+			}
+
+		__atomic_add_fetch(&pipe->stat.stage[stg->stage].busy, _cli$now(CLOCK_MONOTONIC) - t0, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&pipe->stat.stage[stg->stage].idle, idle, __ATOMIC_RELAXED);
+
+		/* The last stage returns the slot to the free ring */
+		_cli$ring_put(&pipe->rings[stg->stage + 1], slot);
+
+		} while ( !eof );
+
+	return	NULL;
+}
+
+/* Pass a last slot through the running stages, every stage exits after it, release resources */
+static	void	_cli$pipe_release	(
+		CLI_PIPE *pipe,
+		int	nstages
+			)
+{
+CLI_PIPESLOT	*slot;
+int		i;
+
+	if ( nstages )
+		{
+		_cli$ring_get(&pipe->rings[CLI$K_PIPE_FREE], &slot);
+		slot->eof = 1;
+		_cli$ring_put(&pipe->rings[CLI$K_PIPE_PARSE], slot);
+		}
+
+	for ( i = 0; i < nstages; i++)
+		pthread_join(pipe->stgs[i].tid, NULL);
+
+	for ( i = 0; i < pipe->depth; i++)
+		{
+		free(pipe->slots[i].line);
+		free(pipe->slots[i].argv);
+		free(pipe->slots[i].toks);
+		}
+
+	for ( i = 0; i <= CLI$K_PIPE_STAGES; i++)
+		{
+		free(pipe->rings[i].slots);
+		pthread_mutex_destroy(&pipe->rings[i].lock);
+		pthread_cond_destroy(&pipe->rings[i].cond);
+		}
+
+	free(pipe->slots);
+	free(pipe);
+}
+
+/*
+ *
+ *  DESCRIPTION: create a pipeline: allocate slots and rings, start stages' threads.
+ *
+ *  INPUT:
+ *	verbs:	commands' verbs definition structure, null entry terminated
+ *	cfg:	a configuration, NULL - default depth, stage N is pinned to CPU N
+ *	ast:	a completion routine, can be NULL
+ *
+ *  OUTPUT:
+ *	pipe:	a pipeline's handle
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$pipe_init	(
+	CLI_PIPE	**pipe,
+	CLI_VERB	*verbs,
+	CLI_PIPECFG	*cfg,
+	CLI_PIPEAST	ast
+			)
+{
+CLI_PIPE	*pp;
+int		i, depth, ncpus, cpu, rc;
+cpu_set_t	cpus;
+
+	depth = (cfg && cfg->depth) ? cfg->depth : CLI$K_PIPE_DEPTH;
+
+	if ( (depth < 2) || (depth & (depth - 1)) )
+		return	$LOG(STS$K_ERROR, "Ring's depth (%d) must be a power of 2", depth);
+
+	if ( !(*pipe = pp = calloc(1, sizeof(CLI_PIPE))) || !(pp->slots = calloc(depth, sizeof(CLI_PIPESLOT))) )
+		{
+		free(pp);
+		return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+		}
+
+	pp->verbs = verbs;
+	pp->opts = (cfg ? cfg->opts : 0) & (~CLI$M_OPSIGNAL);
+	pp->depth = depth;
+	pp->ast = ast;
+
+	for ( i = 0; i <= CLI$K_PIPE_STAGES; i++)
+		{
+		pp->rings[i].mask = depth - 1;
+		pthread_mutex_init(&pp->rings[i].lock, NULL);
+		pthread_cond_init(&pp->rings[i].cond, NULL);
+		}
+
+	for ( i = 0; i <= CLI$K_PIPE_STAGES; i++)
+		{
+		if ( !(pp->rings[i].slots = calloc(depth, sizeof(CLI_PIPESLOT *))) )
+			{
+			*pipe = NULL;
+			_cli$pipe_release(pp, 0);
+			return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+			}
+		}
+
+	/* All slots are free at start */
+	for ( i = 0; i < depth; i++)
+		pp->rings[CLI$K_PIPE_FREE].slots[i] = &pp->slots[i];
+
+	pp->rings[CLI$K_PIPE_FREE].tail = depth;
+	pp->start = _cli$now(CLOCK_MONOTONIC);
+
+	ncpus = $MAX(1, sysconf(_SC_NPROCESSORS_ONLN));
+
+	for ( i = 0; i < CLI$K_PIPE_STAGES; i++)
+		{
+		pp->stgs[i].pipe = pp;
+		pp->stgs[i].stage = i;
+
+		if ( (rc = pthread_create(&pp->stgs[i].tid, NULL, _cli$pipe_stage, &pp->stgs[i])) )
+			{
+			*pipe = NULL;
+			_cli$pipe_release(pp, i);
+			return	$LOG(STS$K_FATAL, "pthread_create(), errno=%d", rc);
+			}
+
+		if ( 0 > (cpu = cfg ? cfg->cpus[i] : i % ncpus) )
+			continue;
+
+		CPU_ZERO(&cpus);
+		CPU_SET(cpu, &cpus);
+
+		if ( (rc = pthread_setaffinity_np(pp->stgs[i].tid, sizeof(cpus), &cpus)) )
+			$LOG(STS$K_WARN, "Cannot pin stage #%d to CPU #%d, errno=%d", i, cpu, rc);
+		}
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: put a command line into the pipeline, wait for a free slot if the pipeline is full.
+ *
+ *  INPUT:
+ *	pipe:	a pipeline's handle
+ *	line:	a command line's text
+ *	len:	a length of the text
+ *	arg:	an argument to be passed to the completion routine
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$pipe_submit	(
+	CLI_PIPE	*pipe,
+		char	*line,
+		int	len,
+		void	*arg
+			)
+{
+CLI_PIPESLOT	*slot;
+unsigned long long wait;
+char		*cp;
+int		status;
+
+	if ( (wait = _cli$ring_get(&pipe->rings[CLI$K_PIPE_FREE], &slot)) )
+		{
+		__atomic_add_fetch(&pipe->stat.stalls, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&pipe->stat.stallns, wait, __ATOMIC_RELAXED);
+		}
+
+	slot->arg = arg;
+	slot->status = STS$K_SUCCESS;
+
+	/*
+	 * Slot's buffers are kept between commands. The free ring has a single producer (dispatch stage),
+	 * so a slot is never returned by the submitter: a failed command goes through the stages as is.
+	 */
+	if ( (len >= slot->linesz) && (cp = realloc(slot->line, $MAX(len + 1, 2 * slot->linesz))) )
+		{
+		slot->line = cp;
+		slot->linesz = $MAX(len + 1, 2 * slot->linesz);
+		}
+
+	if ( len < slot->linesz )
+		{
+		memcpy(slot->line, line, len);
+		slot->line[len] = '\0';
+		}
+	else	slot->status = $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+
+	__atomic_add_fetch(&pipe->stat.submitted, 1, __ATOMIC_RELAXED);
+
+	/* The slot belongs to the stages after this point */
+	status = slot->status;
+	_cli$ring_put(&pipe->rings[CLI$K_PIPE_PARSE], slot);
+
+	return	status;
+}
+
+int	cli$pipe_stat	(
+	CLI_PIPE	*pipe,
+	CLI_PIPESTAT	*stat
+			)
+{
+int	i;
+
+	stat->submitted = __atomic_load_n(&pipe->stat.submitted, __ATOMIC_RELAXED);
+	stat->stalls = __atomic_load_n(&pipe->stat.stalls, __ATOMIC_RELAXED);
+	stat->stallns = __atomic_load_n(&pipe->stat.stallns, __ATOMIC_RELAXED);
+	stat->elapsed = _cli$now(CLOCK_MONOTONIC) - pipe->start;
+
+	for ( i = 0; i < CLI$K_PIPE_STAGES; i++)
+		{
+		stat->stage[i].items = __atomic_load_n(&pipe->stat.stage[i].items, __ATOMIC_RELAXED);
+		stat->stage[i].busy = __atomic_load_n(&pipe->stat.stage[i].busy, __ATOMIC_RELAXED);
+		stat->stage[i].idle = __atomic_load_n(&pipe->stat.stage[i].idle, __ATOMIC_RELAXED);
+		stat->stage[i].util = stat->elapsed ? (int) ((stat->stage[i].busy * 100) / stat->elapsed) : 0;
+		}
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: complete all submitted commands, stop stages' threads and release the pipeline.
+ *
+ *  INPUT:
+ *	pipe:	a pipeline's handle
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$pipe_free	(
+	CLI_PIPE	*pipe
+			)
+{
+	_cli$pipe_release(pipe, CLI$K_PIPE_STAGES);
+
+	return	STS$K_SUCCESS;
+}
+
+
+/*
+ * Recording of the command traffic: a record is built at cli$parse(), completed by cli$dispatch()
+ * and is appended to the shared buffer at cli$cleanup(), the buffer is written by large chunks.
+ */
+#define	CLI$S_RECBUF	(64 * 1024)
+
+static	pthread_mutex_t	cli$rec_lock = PTHREAD_MUTEX_INITIALIZER;
+static	char		*cli$rec_buf;
+static	int		cli$rec_len;
+
+static	int	_cli$rec_write	(
+		int	fd,
+	const	char	*buf,
+		int	len
+			)
+{
+int	rc;
+
+	for ( ; len; buf += rc, len -= rc)
+		{
+		if ( 0 > (rc = write(fd, buf, len)) )
+			{
+			if ( errno == EINTR )
+				{
+				rc = 0;
+				continue;
+				}
+
+			return	$LOG(STS$K_ERROR, "write(#%d), errno=%d", fd, errno);
+			}
+		}
+
+	return	STS$K_SUCCESS;
+}
+
+/*
+ *
+ *  DESCRIPTION: build a record of the command line has been parsed, the record is kept in the context.
+ *		The record isn't accounted against the context's memory limits.
+ *
+ *  INPUT:
+ *	clictx:	A CLI-context
+ *	argc:	a number of arguments
+ *	argv:	arguments
+ *	status:	a status of the parsing
+ *	t0:	a start time of the parsing, CLOCK_MONOTONIC
+ *
+ *  RETURN:
+ *	NONE
+ *
+ */
+static	void	_cli$rec_parse	(
+		CLI_CTX	*clictx,
+		int	argc,
+		char	**argv,
+		int	status,
+	unsigned long long t0
+			)
+{
+CLI_RECHDR	*rec;
+unsigned long long now = _cli$now(CLOCK_MONOTONIC);
+size_t		len = sizeof(CLI_RECHDR), sz;
+char		*cp;
+int		i;
+
+	for ( i = 0; i < argc; i++)
+		len += strlen(argv[i]) + 1;
+
+	len = (len + 7) & (~7);
+
+	if ( !(rec = calloc(1, len)) )
+		return;
+
+	rec->len = len;
+	rec->argc = argc;
+	rec->opts = clictx->opts;
+	rec->psts = status;
+	rec->tparse = now - t0;
+	rec->tstamp = _cli$now(CLOCK_REALTIME) - rec->tparse;
+
+	for ( i = 0, cp = (char *) (rec + 1); i < argc; i++, cp += sz)
+		memcpy(cp, argv[i], sz = strlen(argv[i]) + 1);
+
+	clictx->rec = rec;
+}
+
+static	void	_cli$rec_commit	(
+		CLI_CTX	*clictx
+			)
+{
+CLI_RECHDR	*rec = clictx->rec;
+
+	clictx->rec = NULL;
+
+	pthread_mutex_lock(&cli$rec_lock);
+
+	/* Recording has been stopped after the command has been parsed */
+	if ( 0 <= cli$rec_fd )
+		{
+		if ( cli$rec_len + rec->len > CLI$S_RECBUF )
+			{
+			_cli$rec_write(cli$rec_fd, cli$rec_buf, cli$rec_len);
+			cli$rec_len = 0;
+			}
+
+		if ( rec->len > CLI$S_RECBUF )
+			_cli$rec_write(cli$rec_fd, (char *) rec, rec->len);
+		else	{
+			memcpy(cli$rec_buf + cli$rec_len, rec, rec->len);
+			cli$rec_len += rec->len;
+			}
+		}
+
+	pthread_mutex_unlock(&cli$rec_lock);
+
+	free(rec);
+}
+
+/*
+ *
+ *  DESCRIPTION: start recording of the command traffic into the log file, records are appended
+ *		to an existing log.
+ *
+ *  INPUT:
+ *	fspec:	a log file specification
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$record_start(
+		char	*fspec
+			)
+{
+int	fd, status = STS$K_SUCCESS;
+struct stat st;
+char	magic[8];
+
+	if ( 0 > (fd = open(fspec, O_RDWR | O_CREAT | O_APPEND, 0640)) )
+		return	$LOG(STS$K_ERROR, "open(%s), errno=%d", fspec, errno);
+
+	if ( fstat(fd, &st) )
+		status = $LOG(STS$K_ERROR, "fstat(%s), errno=%d", fspec, errno);
+	else if ( !st.st_size )
+		status = _cli$rec_write(fd, CLI$T_RECMAGIC, sizeof(magic));
+	else if ( (sizeof(magic) != pread(fd, magic, sizeof(magic), 0)) || memcmp(magic, CLI$T_RECMAGIC, sizeof(magic)) )
+		status = $LOG(STS$K_ERROR, "'%s' is not a traffic log", fspec);
+
+	pthread_mutex_lock(&cli$rec_lock);
+
+	if ( (1 & status) && (0 <= cli$rec_fd) )
+		status = $LOG(STS$K_ERROR, "Recording is already active");
+
+	if ( (1 & status) && !cli$rec_buf && !(cli$rec_buf = malloc(CLI$S_RECBUF)) )
+		status = $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+
+	if ( 1 & status )
+		{
+		cli$rec_len = 0;
+		__atomic_store_n(&cli$rec_fd, fd, __ATOMIC_RELEASE);
+		}
+
+	pthread_mutex_unlock(&cli$rec_lock);
+
+	if ( !(1 & status) )
+		close(fd);
+
+	return	status;
+}
+
+int	cli$record_flush(void)
+{
+int	status = STS$K_SUCCESS;
+
+	pthread_mutex_lock(&cli$rec_lock);
+
+	if ( (0 <= cli$rec_fd) && cli$rec_len )
+		status = _cli$rec_write(cli$rec_fd, cli$rec_buf, cli$rec_len);
+
+	cli$rec_len = 0;
+
+	pthread_mutex_unlock(&cli$rec_lock);
+
+	return	status;
+}
+
+int	cli$record_stop	(void)
+{
+int	status = STS$K_SUCCESS;
+
+	pthread_mutex_lock(&cli$rec_lock);
+
+	if ( 0 <= cli$rec_fd )
+		{
+		if ( cli$rec_len )
+			status = _cli$rec_write(cli$rec_fd, cli$rec_buf, cli$rec_len);
+
+		close(cli$rec_fd);
+		__atomic_store_n(&cli$rec_fd, -1, __ATOMIC_RELEASE);
+		}
+
+	free(cli$rec_buf);
+	cli$rec_buf = NULL;
+	cli$rec_len = 0;
+
+	pthread_mutex_unlock(&cli$rec_lock);
+
+	return	status;
+}
+
+static	void	_cli$lat_add	(
+		CLI_LATSTAT *lat,
+	unsigned long long v
+			)
+{
+	lat->count++;
+	lat->sum += v;
+	lat->max = $MAX(lat->max, v);
+	lat->hist[63 - __builtin_clzll(v | 1)]++;
+}
+
+/* Percentiles are upper bounds of the histogram's buckets */
+static	void	_cli$lat_done	(
+		CLI_LATSTAT *lat
+			)
+{
+unsigned long long n = 0, p50 = (lat->count * 50 + 99) / 100, p90 = (lat->count * 90 + 99) / 100, p99 = (lat->count * 99 + 99) / 100, ub;
+int	i;
+
+	for ( i = 0; lat->count && (i < CLI$K_LATHIST); i++)
+		{
+		if ( !lat->hist[i] )
+			continue;
+
+		n += lat->hist[i];
+		ub = $MIN((i < 63) ? (2ULL << i) - 1 : ~0ULL, lat->max);
+
+		if ( !lat->p50 && (n >= p50) )
+			lat->p50 = ub;
+		if ( !lat->p90 && (n >= p90) )
+			lat->p90 = ub;
+		if ( !lat->p99 && (n >= p99) )
+			lat->p99 = ub;
+		}
+}
+
+/*
+ *
+ *  DESCRIPTION: replay the traffic log: every command line is parsed (and dispatched) again,
+ *		latencies are collected along with the recorded ones.
+ *
+ *  INPUT:
+ *	verbs:	commands' verbs definition structure, null entry terminated
+ *	opts:	processing options are added to the recorded ones, see CLI$M_OP*, CLI$M_OPSIGNAL is ignored
+ *	fspec:	a log file specification
+ *	flags:	CLI$M_REPLAY_* options
+ *
+ *  OUTPUT:
+ *	stat:	a buffer to accept counters and latencies
+ *
+ *  RETURN:
+ *	SS$_NORMAL, condition status
+ *
+ */
+int	cli$replay	(
+	CLI_VERB	*verbs,
+		int	opts,
+		char	*fspec,
+		int	flags,
+	CLI_REPLAYSTAT	*stat
+			)
+{
+int		fd, nullfd = -1, status = STS$K_SUCCESS, psts, dsts, maxargc = 0, i, dispatched;
+struct stat	st;
+char		*base, *cp, *end, **argv = NULL, **av;
+CLI_RECHDR	*rec;
+void		*clictx;
+unsigned long long off, start, first = 0, t0, t1, t2;
+struct timespec	ts;
+
+	memset(stat, 0, sizeof(CLI_REPLAYSTAT));
+
+	if ( 0 > (fd = open(fspec, O_RDONLY)) )
+		return	$LOG(STS$K_ERROR, "open(%s), errno=%d", fspec, errno);
+
+	if ( fstat(fd, &st) )
+		{
+		close(fd);
+		return	$LOG(STS$K_ERROR, "fstat(%s), errno=%d", fspec, errno);
+		}
+
+	if ( (st.st_size < 8) || (MAP_FAILED == (base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0))) )
+		{
+		close(fd);
+		return	$LOG(STS$K_ERROR, "mmap(%s), errno=%d", fspec, errno);
+		}
+
+	close(fd);
+	madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+	if ( memcmp(base, CLI$T_RECMAGIC, 8) )
+		{
+		munmap(base, st.st_size);
+		return	$LOG(STS$K_ERROR, "'%s' is not a traffic log", fspec);
+		}
+
+	/* Output of the action routines is discarded */
+	if ( (flags & CLI$M_REPLAY_DISPATCH) && (0 > (nullfd = open("/dev/null", O_WRONLY))) )
+		{
+		munmap(base, st.st_size);
+		return	$LOG(STS$K_ERROR, "open(/dev/null), errno=%d", errno);
+		}
+
+	start = _cli$now(CLOCK_MONOTONIC);
+
+	for ( off = 8; (1 & status) && (off + sizeof(CLI_RECHDR) <= (unsigned long long) st.st_size); off += rec->len)
+		{
+		rec = (CLI_RECHDR *) (base + off);
+
+		if ( (rec->len < sizeof(CLI_RECHDR)) || (rec->len & 7) || (off + rec->len > (unsigned long long) st.st_size) )
+			{
+			status = $LOG(STS$K_ERROR, "Corrupted record at offset %llu", off);
+			break;
+			}
+
+		if ( (int) rec->argc > maxargc )
+			{
+			if ( !(av = realloc(argv, (rec->argc + 1) * sizeof(char *))) )
+				{
+				status = $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+				break;
+				}
+
+			argv = av;
+			maxargc = rec->argc;
+			}
+
+		/* Arguments are zero-terminated strings after the header */
+		for ( i = 0, cp = (char *) (rec + 1), end = base + off + rec->len; (i < (int) rec->argc) && (cp < end); i++)
+			{
+			argv[i] = cp;
+
+			if ( !(cp = memchr(cp, '\0', end - cp)) )
+				break;
+
+			cp++;
+			}
+
+		if ( i < (int) rec->argc )
+			{
+			status = $LOG(STS$K_ERROR, "Corrupted record at offset %llu", off);
+			break;
+			}
+
+		argv[i] = NULL;
+
+		/* Keep original intervals between commands */
+		if ( !first )
+			first = rec->tstamp;
+		else if ( (flags & CLI$M_REPLAY_PACED) && (rec->tstamp > first) )
+			{
+			t0 = start + (rec->tstamp - first);
+			ts.tv_sec = t0 / 1000000000ULL;
+			ts.tv_nsec = t0 % 1000000000ULL;
+
+			while ( EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) );
+			}
+
+		clictx = NULL;
+		dispatched = 0;
+		dsts = rec->dsts;
+
+		t0 = _cli$now(CLOCK_MONOTONIC);
+		psts = cli$parse(verbs, (rec->opts | opts) & ~CLI$M_OPSIGNAL, rec->argc, argv, &clictx);
+		t2 = t1 = _cli$now(CLOCK_MONOTONIC);
+
+		if ( (1 & psts) && (flags & CLI$M_REPLAY_DISPATCH) && (rec->flags & CLI$M_REC_DISPATCHED) )
+			{
+			cli$set_output(clictx, nullfd, CLI$K_OUT_TEXT);
+			dsts = cli$dispatch(clictx);
+			t2 = _cli$now(CLOCK_MONOTONIC);
+			dispatched = 1;
+			}
+
+		if ( clictx )
+			cli$cleanup(clictx);
+
+		stat->nrecs++;
+
+		if ( ((1 & psts) != (1 & rec->psts)) || ((1 & dsts) != (1 & rec->dsts)) )
+			stat->nmismatch++;
+
+		_cli$lat_add(&stat->orig[CLI$K_STAGE_PARSE], rec->tparse);
+		_cli$lat_add(&stat->replay[CLI$K_STAGE_PARSE], t1 - t0);
+
+		if ( rec->flags & CLI$M_REC_DISPATCHED )
+			_cli$lat_add(&stat->orig[CLI$K_STAGE_DISPATCH], rec->tdispatch);
+
+		if ( dispatched )
+			_cli$lat_add(&stat->replay[CLI$K_STAGE_DISPATCH], t2 - t1);
+
+		_cli$lat_add(&stat->orig[CLI$K_STAGE_TOTAL], rec->tparse + rec->tdispatch);
+		_cli$lat_add(&stat->replay[CLI$K_STAGE_TOTAL], t2 - t0);
+		}
+
+	stat->elapsed = _cli$now(CLOCK_MONOTONIC) - start;
+	stat->rate = stat->elapsed ? (stat->nrecs * 1000000000ULL) / stat->elapsed : 0;
+
+	for ( i = 0; i < CLI$K_STAGES; i++)
+		{
+		_cli$lat_done(&stat->orig[i]);
+		_cli$lat_done(&stat->replay[i]);
+		}
+
+	if ( nullfd >= 0 )
+		close(nullfd);
+
+	free(argv);
+	munmap(base, st.st_size);
+
+	return	status;
+}
+
+
+
+#ifdef	__CLI_REPLAY__
+/*
+ * Replay utility: the verbs table is loaded from the application's shared object,
+ *
+ *	cli_replay [-p] [-d] [-s <symbol>] <shared object> <traffic log>
+ *
+ *	-p	keep original intervals between commands, default is maximum speed
+ *	-d	call action routines
+ *	-s	a name of the verbs table in the shared object, default is CLI$T_REPLAYSYM
+ */
+#define	CLI$T_REPLAYSYM	"cli$verbs"
+
+static	void	_cli$replay_show	(
+	const	char	*title,
+		CLI_LATSTAT *lat
+			)
+{
+	if ( !lat->count )
+		return;
+
+	printf("  %-20s %10llu %10llu %10llu %10llu %10llu %10llu\n", title, lat->count, lat->sum / lat->count,
+		lat->p50 / 1000, lat->p90 / 1000, lat->p99 / 1000, lat->max / 1000);
+}
+
+int	main	(int argc, char **argv)
+{
+int	c, flags = 0, status, i;
+char	*sym = CLI$T_REPLAYSYM;
+void	*hdl;
+CLI_VERB *verbs;
+CLI_REPLAYSTAT	stat;
+static const char *stages [CLI$K_STAGES] = {"parse", "dispatch", "total"};
+char	title[64];
+
+	while ( -1 != (c = getopt(argc, argv, "pds:")) )
+		{
+		switch ( c )
+			{
+			case	'p':	flags |= CLI$M_REPLAY_PACED; break;
+			case	'd':	flags |= CLI$M_REPLAY_DISPATCH; break;
+			case	's':	sym = optarg; break;
+			default:
+				optind = argc;
+			}
+		}
+
+	if ( argc - optind != 2 )
+		{
+		fprintf(stderr, "Usage: %s [-p] [-d] [-s <symbol>] <shared object> <traffic log>\n", argv[0]);
+		return	-EINVAL;
+		}
+
+	if ( !(hdl = dlopen(argv[optind], RTLD_NOW)) || !(verbs = dlsym(hdl, sym)) )
+		{
+		$LOG(STS$K_ERROR, "Cannot load '%s' from '%s': %s", sym, argv[optind], dlerror());
+		return	-ENOENT;
+		}
+
+	if ( !(1 & (status = cli$replay(verbs, 0, argv[optind + 1], flags, &stat))) )
+		return	-EINVAL;
+
+	printf("Commands: %llu, status mismatches: %llu, elapsed: %llu msecs, rate: %llu commands/sec\n",
+		stat.nrecs, stat.nmismatch, stat.elapsed / 1000000, stat.rate);
+
+	printf("  %-20s %10s %10s %10s %10s %10s %10s\n", "stage", "count", "mean(ns)", "p50(us)", "p90(us)", "p99(us)", "max(us)");
+
+	for ( i = 0; i < CLI$K_STAGES; i++)
+		{
+		snprintf(title, sizeof(title), "%s/recorded", stages[i]);
+		_cli$replay_show(title, &stat.orig[i]);
+		snprintf(title, sizeof(title), "%s/replayed", stages[i]);
+		_cli$replay_show(title, &stat.replay[i]);
+		}
+
+	return	0;
+}
+#endif	/* __CLI_REPLAY__ */
+
+
+
+#ifdef	__CLI_DEBUG__
+
+#include	<stdio.h>
+#include	<errno.h>
+#include	<pwd.h>
+#include	<grp.h>
+#include	<fnmatch.h>
+#include	<sys/ioctl.h>
+#include	<sys/sysmacros.h>
+#include	<linux/fs.h>
+#include	<dirent.h>
+
+
+/*
+	SHOW	VOLUME	<p1-volume_name>/UUID=<uuid> /FULL
+		USER	<p1-user-name>  /FULL /GROUP=<user_group_name>
+		VM	<p1-VM-name>	/FULL /GROUP=<vm_group_name>
+
+	DIFF	<p1-file-name> <p2-file-name> /BLOCK=(START=<lbn>, END=<lbn>, COUNT=<lbn>)
+			/IGNORE=(ERROR) /LOGGING=(FULL, TRACE, ERROR)
+
+*/
+
+enum	{
+	SHOW$K_VOLUME = 1,
+	SHOW$K_USER,
+	SHOW$K_VM
+};
+
+
+enum	{
+	DIFF$K_FULL = 1,
+	DIFF$K_TRACE = 2,
+	DIFF$K_ERROR = 4
+};
+
+CLI_KEYWORD	diff_log_opts[] = {
+			{ .name = {$ASCINI("FULL")},	.val = DIFF$K_FULL},
+			{ .name = {$ASCINI("TRACE")},	.val = DIFF$K_TRACE},
+			{ .name = {$ASCINI("ERROR")},	.val = DIFF$K_ERROR},
+			{0}},
+
+		show_what_opts [] = {
+			{ .name = {$ASCINI("VOLUME")},	.val = SHOW$K_VOLUME},
+			{ .name = {$ASCINI("USER")},	.val = SHOW$K_USER},
+			{ .name = {$ASCINI("VM")},	.val = SHOW$K_VM},
+			{0}};
+
+CLI_PQDESC	diff_quals [] = {
+			{ .name = {$ASCINI("START")},	.type = CLI$K_NUM},
+			{ .name = {$ASCINI("END")},	.type = CLI$K_NUM},
+			{ .name = {$ASCINI("COUNT")},	.type = CLI$K_NUM},
+			{ .name = {$ASCINI("IGNORE")},	.type = CLI$K_OPT},
+			{ .name = {$ASCINI("LOGGING")}, .type = CLI$K_KWD, .flag = CLI$M_LIST, .kwd = diff_log_opts},
+			{0}},
+
+		show_volume_quals [] = {
+			{ .name = {$ASCINI("UUID")},	CLI$K_UUID},
+			{ .name = {$ASCINI("FULL")},	CLI$K_OPT},
+			{0}},
+		show_user_quals [] = {
+			{ .name = {$ASCINI("GROUP")},	CLI$K_QSTRING},
+			{ .name = {$ASCINI("FULL")},	CLI$K_OPT},
+			{0}},
+		show_vm_quals [] = {
+			{ .name = {$ASCINI("GROUP")},	CLI$K_QSTRING},
+			{ .name = {$ASCINI("FULL")},	CLI$K_OPT},
+			{0}};
+
+CLI_PQDESC	diff_params [] = {
+			{.pn = CLI$K_P1, .type = CLI$K_FILE, .name = {$ASCINI("Input file 1")} },
+			{.pn = CLI$K_P2, .type = CLI$K_FILE, .name = {$ASCINI("Input file 2")} },
+			{0}},
+
+		show_volume_params [] = {
+			{.pn = CLI$K_P1, .type = CLI$K_DEVICE, .name = {$ASCINI("Volume name (eg: sdb, sdb1, sda5, sd*)")} },
+			{0}},
+
+		show_user_params [] = {
+			{.pn = CLI$K_P1, .type = CLI$K_QSTRING,  .name = {$ASCINI("User spec")}},
+			{0}},
+
+		show_vm_params [] = {
+			{.pn = CLI$K_P1, .type = CLI$K_QSTRING,  .name = {$ASCINI("VM Id")}},
+			{0}};
+
+
+int	diff_action	( CLI_CTX *clictx, void *arg);
+int	show_action	( CLI_CTX *clictx, void *arg);
+
+CLI_VERB	show_what []  = {
+	{ {$ASCINI("volume")},	.params = show_volume_params, .quals = show_volume_quals , .act_rtn = show_action, .act_arg = SHOW$K_VOLUME,
+				.flags = CLI$M_VERB_IDEMPOTENT, .ttl = 1000, .sched = CLI$K_SCHED_INTERACTIVE },
+	{ {$ASCINI("vm")},	.params = show_vm_params, .quals = show_vm_quals,  .act_rtn = show_action, .act_arg = SHOW$K_VM,
+				.flags = CLI$M_VERB_IDEMPOTENT, .ttl = 1000, .sched = CLI$K_SCHED_INTERACTIVE },
+	{ {$ASCINI("user")},	.params = show_user_params, .quals = show_user_quals , .act_rtn = show_action, .act_arg = SHOW$K_USER,
+				.flags = CLI$M_VERB_IDEMPOTENT, .ttl = 5000, .sched = CLI$K_SCHED_INTERACTIVE },
+	{0}};
+
+
+CLI_VERB	top_commands []  = {
+	{ .name = {$ASCINI("diff")}, .params = diff_params, .quals = diff_quals , .act_rtn = diff_action,
+				.sched = CLI$K_SCHED_BATCH, .cost = 100 },
+	{ .name = {$ASCINI("show")}, .next = show_what},
+	{0}};
+
+ASC	prompt = {$ASCINI("CRYPTORCP>")};
+
+
+/*
+ * DIFF engine: both inputs are read by large aligned chunks (pread), chunks are distributed
+ * over threads, 512-octets blocks (LBN) are compared by SIMD kernel, differing LBN ranges
+ * are merged in order and put into the output sink.
+ */
+#define	DIFF$K_LBNSZ	512
+#define	DIFF$S_CHUNK	(4*1024*1024)			/* A size of the single read	*/
+#define	DIFF$K_CHUNKLBNS (DIFF$S_CHUNK / DIFF$K_LBNSZ)
+#define	DIFF$K_MAXTHREADS 16
+
+typedef	int	(*DIFF_KRNL) (const char *a, const char *b);
+
+typedef struct __diff_res__
+{
+	int	status,
+		nranges;
+
+	unsigned long long range [][2];		/* Start LBN, count		*/
+} DIFF_RES;
+
+typedef struct __diff_job__
+{
+	CLI_CTX		*clictx;
+
+	int		fd1, fd2,
+			ignore,			/* Continue on I/O errors	*/
+			logging,		/* DIFF$K_* mask		*/
+			stop,
+			status;
+
+	DIFF_KRNL	krnl;
+
+	unsigned long long slbn,		/* A range to be compared	*/
+			elbn,			/* (exclusive)			*/
+			nchunks,
+			next,			/* A next chunk to be read	*/
+			emit,			/* A next chunk to be reported	*/
+			rstart, rcount,		/* A range is being merged	*/
+			ndiff, nranges, nerrs;
+
+	pthread_mutex_t	lock;
+	DIFF_RES	**res;			/* Completed chunks, by index	*/
+} DIFF_JOB;
+
+/* Return non-zero if two LBNs differ */
+static	int	_diff_scalar	(
+	const	char	*a,
+	const	char	*b
+			)
+{
+const unsigned long long *pa = (const unsigned long long *) a, *pb = (const unsigned long long *) b;
+unsigned long long acc = 0;
+int	i;
+
+	for ( i = 0; i < DIFF$K_LBNSZ / 8; i++)
+		acc |= pa[i] ^ pb[i];
+
+	return	acc != 0;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse2")))
+static	int	_diff_sse2	(
+	const	char	*a,
+	const	char	*b
+			)
+{
+__m128i	acc = _mm_setzero_si128();
+int	i;
+
+	for ( i = 0; i < DIFF$K_LBNSZ; i += 16)
+		acc = _mm_or_si128(acc, _mm_xor_si128(_mm_load_si128((const __m128i *) (a + i)), _mm_load_si128((const __m128i *) (b + i))));
+
+	return	_mm_movemask_epi8(_mm_cmpeq_epi8(acc, _mm_setzero_si128())) != 0xffff;
+}
+
+__attribute__((target("avx2")))
+static	int	_diff_avx2	(
+	const	char	*a,
+	const	char	*b
+			)
+{
+__m256i	acc = _mm256_setzero_si256();
+int	i;
+
+	for ( i = 0; i < DIFF$K_LBNSZ; i += 32)
+		acc = _mm256_or_si256(acc, _mm256_xor_si256(_mm256_load_si256((const __m256i *) (a + i)), _mm256_load_si256((const __m256i *) (b + i))));
+
+	return	!_mm256_testz_si256(acc, acc);
+}
+#endif	/* __x86_64__ || __i386__ */
+
+static	DIFF_KRNL	_diff_kernel	(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+
+	if ( __builtin_cpu_supports("avx2") )
+		return	_diff_avx2;
+
+	if ( __builtin_cpu_supports("sse2") )
+		return	_diff_sse2;
+#endif
+
+	return	_diff_scalar;
+}
+
+/* Read whole chunk, a short read at EOF is zero-filled */
+static	int	_diff_read	(
+		int	fd,
+		char	*buf,
+		size_t	sz,
+		off_t	off
+			)
+{
+ssize_t	rc;
+size_t	done;
+
+	for ( done = 0; done < sz; done += rc)
+		{
+		if ( 0 > (rc = pread(fd, buf + done, sz - done, off + done)) )
+			{
+			if ( errno == EINTR )
+				{
+				rc = 0;
+				continue;
+				}
+
+			return	errno;
+			}
+
+		if ( !rc )
+			{
+			memset(buf + done, 0, sz - done);
+			break;
+			}
+		}
+
+	return	0;
+}
+
+static	int	_diff_size	(
+		int	fd,
+	unsigned long long *sz
+			)
+{
+struct stat	st;
+
+	if ( fstat(fd, &st) )
+		return	errno;
+
+	if ( S_ISBLK(st.st_mode) )
+		return	ioctl(fd, BLKGETSIZE64, sz) ? errno : 0;
+
+	*sz = st.st_size;
+
+	return	0;
+}
+
+/* Put has been merged range into the sink, must be called under the job's lock */
+static	int	_diff_put_range	(
+		DIFF_JOB	*job
+			)
+{
+char	start[32], end[32], count[32];
+const char *rec[] = {start, end, count};
+
+	if ( !job->rcount )
+		return	STS$K_SUCCESS;
+
+	snprintf(start, sizeof(start), "%llu", job->rstart);
+	snprintf(end, sizeof(end), "%llu", job->rstart + job->rcount - 1);
+	snprintf(count, sizeof(count), "%llu", job->rcount);
+
+	job->nranges++;
+	job->rcount = 0;
+
+	return	cli$put_output(job->clictx, 3, rec);
+}
+
+/* Report completed chunks in order, must be called under the job's lock */
+static	void	_diff_emit	(
+		DIFF_JOB	*job
+			)
+{
+DIFF_RES	*res;
+int		i, status;
+
+	for ( ; (job->emit < job->nchunks) && (res = job->res[job->emit]); job->emit++)
+		{
+		job->res[job->emit] = NULL;
+
+		if ( !(1 & res->status) )
+			{
+			job->nerrs++;
+
+			if ( !job->ignore )
+				{
+				job->status = res->status;
+				job->stop = 1;
+				}
+			}
+
+		for ( i = 0; i < res->nranges; i++)
+			{
+			job->ndiff += res->range[i][1];
+
+			/* Continue a range from the previous chunk */
+			if ( job->rcount && (job->rstart + job->rcount == res->range[i][0]) )
+				{
+				job->rcount += res->range[i][1];
+				continue;
+				}
+
+			if ( !(1 & (status = _diff_put_range(job))) )
+				{
+				job->status = status;
+				job->stop = 1;
+				}
+
+			job->rstart = res->range[i][0];
+			job->rcount = res->range[i][1];
+			}
+
+		free(res);
+		}
+
+	/* Serialized here, so the context's error record is written by a single thread */
+	if ( !job->stop && !(1 & (status = cli$check_cancel(job->clictx))) )
+		{
+		job->status = status;
+		job->stop = 1;
+		}
+}
+
+static	void	*_diff_worker	(
+		void	*arg
+			)
+{
+DIFF_JOB	*job = arg;
+DIFF_RES	*res;
+char		*b1 = NULL, *b2 = NULL;
+unsigned long long k, lbn, n, i;
+int		rc;
+
+	if ( posix_memalign((void **) &b1, 4096, DIFF$S_CHUNK) || posix_memalign((void **) &b2, 4096, DIFF$S_CHUNK) )
+		{
+		pthread_mutex_lock(&job->lock);
+		job->status = $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+		job->stop = 1;
+		pthread_mutex_unlock(&job->lock);
+		free(b1);
+
+		return	NULL;
+		}
+
+	while ( !__atomic_load_n(&job->stop, __ATOMIC_RELAXED)
+		&& ((k = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->nchunks) )
+		{
+		lbn = job->slbn + k * DIFF$K_CHUNKLBNS;
+		n = $MIN(DIFF$K_CHUNKLBNS, job->elbn - lbn);
+
+		/* Worst case: every second LBN differs */
+		if ( !(res = calloc(1, sizeof(DIFF_RES) + ((n + 1) / 2) * sizeof(res->range[0]))) )
+			{
+			pthread_mutex_lock(&job->lock);
+			job->status = $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+			job->stop = 1;
+			pthread_mutex_unlock(&job->lock);
+
+			break;
+			}
+
+		res->status = STS$K_SUCCESS;
+
+		if ( (rc = _diff_read(job->fd1, b1, n * DIFF$K_LBNSZ, lbn * DIFF$K_LBNSZ))
+			|| (rc = _diff_read(job->fd2, b2, n * DIFF$K_LBNSZ, lbn * DIFF$K_LBNSZ)) )
+			{
+			res->status = (job->logging & DIFF$K_ERROR) || !job->ignore
+				? $LOG(STS$K_ERROR, "I/O error at LBN %llu-%llu, errno=%d", lbn, lbn + n - 1, rc) : STS$K_ERROR;
+			}
+		else	{
+			for ( i = 0; i < n; i++)
+				{
+				if ( !job->krnl(b1 + i * DIFF$K_LBNSZ, b2 + i * DIFF$K_LBNSZ) )
+					continue;
+
+				if ( res->nranges && (res->range[res->nranges - 1][0] + res->range[res->nranges - 1][1] == lbn + i) )
+					res->range[res->nranges - 1][1]++;
+				else	{
+					res->range[res->nranges][0] = lbn + i;
+					res->range[res->nranges][1] = 1;
+					res->nranges++;
+					}
+				}
+
+			/* Don't let the page cache be flooded by the volume images */
+			posix_fadvise(job->fd1, lbn * DIFF$K_LBNSZ, n * DIFF$K_LBNSZ, POSIX_FADV_DONTNEED);
+			posix_fadvise(job->fd2, lbn * DIFF$K_LBNSZ, n * DIFF$K_LBNSZ, POSIX_FADV_DONTNEED);
+			}
+
+		$IFTRACE(job->logging & DIFF$K_TRACE, "Chunk #%llu, LBN %llu-%llu, %d ranges", k, lbn, lbn + n - 1, res->nranges);
+
+		pthread_mutex_lock(&job->lock);
+		job->res[k] = res;
+		_diff_emit(job);
+		pthread_mutex_unlock(&job->lock);
+		}
+
+	free(b1);
+	free(b2);
+
+	return	NULL;
+}
+
+int	diff_action	(
+		CLI_CTX		*clictx,
+			void	*arg
+			)
+{
+int	status, i, nthreads, rc, interrupted;
+ASC	fl1, fl2, val;
+char	fspec1[ASC$K_SZ + 1], fspec2[ASC$K_SZ + 1], num[ASC$K_SZ + 1];
+unsigned long long sz1, sz2, nlbns, elapsed;
+pthread_t	tids [DIFF$K_MAXTHREADS];
+DIFF_JOB	job = {.clictx = clictx, .fd1 = -1, .fd2 = -1, .status = STS$K_SUCCESS, .lock = PTHREAD_MUTEX_INITIALIZER};
+CLI_KEYWORD	*kwd;
+CLI_LIST	*list;
+const char	*hdr[] = {"START", "END", "COUNT"};
+const int	widths[] = {12, 12, 0};
+
+	$IFTRACE(clictx->opts & CLI$M_OPTRACE, "Action routine is just called!");
+
+	if ( !(1 & (status = cli$get_value(clictx, &diff_params[0], &fl1))) )
+		return	status;
+
+	if ( !(1 & (status = cli$get_value(clictx, &diff_params[1], &fl2))) )
+		return	status;
+
+	snprintf(fspec1, sizeof(fspec1), "%.*s", $ASC(&fl1));
+	snprintf(fspec2, sizeof(fspec2), "%.*s", $ASC(&fl2));
+
+	$IFTRACE(clictx->opts & CLI$M_OPTRACE, "Comparing %s vs %s", fspec1, fspec2);
+
+	job.ignore = (1 & cli$get_value(clictx, &diff_quals[3], NULL));
+
+	/* /LOGGING=(FULL,TRACE) - a mask of all listed keywords */
+	if ( 1 & cli$list_open(clictx, &diff_quals[4], &list) )
+		{
+		while ( STS$K_WARN != (status = cli$list_next(list, &val)) )
+			{
+			if ( !(1 & status) || !(1 & (status = cli$check_keyword(clictx, $ASCPTR(&val), $ASCLEN(&val), diff_log_opts, &kwd))) )
+				break;
+
+			job.logging |= kwd->val;
+			}
+
+		cli$list_close(list);
+
+		if ( status != STS$K_WARN )
+			return	status;
+		}
+
+	if ( (0 > (job.fd1 = open(fspec1, O_RDONLY))) || (0 > (job.fd2 = open(fspec2, O_RDONLY))) )
+		{
+		status = $LOG(STS$K_ERROR, "Cannot open '%s', errno=%d", (job.fd1 < 0) ? fspec1 : fspec2, errno);
+		goto	done;
+		}
+
+	if ( (rc = _diff_size(job.fd1, &sz1)) || (rc = _diff_size(job.fd2, &sz2)) )
+		{
+		status = $LOG(STS$K_ERROR, "Cannot get size of input, errno=%d", rc);
+		goto	done;
+		}
+
+	/* A range of LBNs: /START, /END (inclusive) or /COUNT, the common part of inputs by default */
+	nlbns = ($MAX(sz1, sz2) + DIFF$K_LBNSZ - 1) / DIFF$K_LBNSZ;
+
+	if ( 1 & cli$get_value(clictx, &diff_quals[0], &val) )
+		{
+		snprintf(num, sizeof(num), "%.*s", $ASC(&val));
+		job.slbn = strtoull(num, NULL, 0);
+		}
+
+	job.elbn = ($MIN(sz1, sz2) + DIFF$K_LBNSZ - 1) / DIFF$K_LBNSZ;
+
+	if ( 1 & cli$get_value(clictx, &diff_quals[1], &val) )
+		{
+		snprintf(num, sizeof(num), "%.*s", $ASC(&val));
+		job.elbn = strtoull(num, NULL, 0) + 1;
+		}
+	else if ( 1 & cli$get_value(clictx, &diff_quals[2], &val) )
+		{
+		snprintf(num, sizeof(num), "%.*s", $ASC(&val));
+		job.elbn = job.slbn + strtoull(num, NULL, 0);
+		}
+
+	job.elbn = $MIN(job.elbn, nlbns);
+
+	if ( job.slbn >= job.elbn )
+		{
+		status = $LOG(STS$K_ERROR, "Empty LBN range %llu-%llu", job.slbn, job.elbn);
+		goto	done;
+		}
+
+	if ( sz1 != sz2 )
+		$LOG(STS$K_WARN, "Inputs sizes are different: %llu vs %llu octets", sz1, sz2);
+
+	job.nchunks = (job.elbn - job.slbn + DIFF$K_CHUNKLBNS - 1) / DIFF$K_CHUNKLBNS;
+	job.krnl = _diff_kernel();
+
+	if ( !(job.res = calloc(job.nchunks, sizeof(DIFF_RES *))) )
+		{
+		status = $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
+		goto	done;
+		}
+
+	posix_fadvise(job.fd1, 0, 0, POSIX_FADV_SEQUENTIAL);
+	posix_fadvise(job.fd2, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	if ( !(1 & (status = cli$put_header(clictx, 3, hdr, widths))) )
+		goto	done;
+
+	nthreads = $MIN($MAX(1, sysconf(_SC_NPROCESSORS_ONLN)), DIFF$K_MAXTHREADS);
+	nthreads = (int) $MIN((unsigned long long) nthreads, job.nchunks);
+
+	elapsed = _cli$now(CLOCK_MONOTONIC);
+
+	for ( i = 0; i < nthreads; i++)
+		if ( pthread_create(&tids[i], NULL, _diff_worker, &job) )
+			break;
+
+	/* No threads at all - do it ourself */
+	if ( !(nthreads = i) )
+		_diff_worker(&job);
+
+	for ( i = 0; i < nthreads; i++)
+		pthread_join(tids[i], NULL);
+
+	elapsed = _cli$now(CLOCK_MONOTONIC) - elapsed;
+
+	/* Chunks after the failed one are never reported */
+	interrupted = job.emit < job.nchunks;
+
+	for ( ; job.emit < job.nchunks; job.emit++)
+		free(job.res[job.emit]);
+
+	if ( 1 & job.status )
+		job.status = _diff_put_range(&job);
+
+	status = job.status;
+
+	if ( (1 & status) && interrupted )
+		status = $LOG(STS$K_ERROR, "Comparison has been interrupted");
+
+	if ( 1 & status )
+		status = cli$flush_output(clictx);
+
+	if ( (job.logging & DIFF$K_FULL) || (clictx->opts & CLI$M_OPTRACE) )
+		$LOG(STS$K_INFO, "Compared LBN %llu-%llu: %llu differ in %llu ranges, %llu errors, %llu MB/s",
+			job.slbn, job.elbn - 1, job.ndiff, job.nranges, job.nerrs,
+			elapsed ? ((job.elbn - job.slbn) * DIFF$K_LBNSZ * 2 * 1000ULL) / elapsed : 0);
+
+done:
+	if ( job.fd1 >= 0 )
+		close(job.fd1);
+
+	if ( job.fd2 >= 0 )
+		close(job.fd2);
+
+	free(job.res);
+
+	$IFTRACE(clictx->opts & CLI$M_OPTRACE, "Action routine has been completed!");
+
+	return	status;
+}
+
+/* Copy a value as zero terminated string, surrounding quotes are removed */
+static	char	*show_value	( ASC *val, char *buf)
+{
+int	len = $ASCLEN(val);
+char	*cp = $ASCPTR(val);
+
+	if ( (len > 1) && (*cp == '"') && (cp[len - 1] == '"') )
+		cp++, len -= 2;
+
+	memcpy(buf, cp, len);
+	buf[len] = '\0';
+
+	return	buf;
+}
+
+/*
+ * Volumes enumeration: /sys/block and its partitions are scanned in one pass into a snapshot
+ * sorted by device number, attributes are kept per device number between scans, UUIDs from
+ * /dev/disk/by-uuid are indexed by a sorted array. Readers take the snapshot by reference.
+ */
+#define	VOL$K_TTL	2000		/* A snapshot's life time, msecs	*/
+
+typedef struct __vol_rec__
+{
+	dev_t	dev;
+
+	char	name [NAME_MAX + 1],
+		model [64],
+		uuid [64];
+
+	unsigned long long sectors;	/* 512-octets			*/
+
+	int	ro,
+		removable,
+		rotational,
+		partition;
+} VOL_REC;
+
+typedef struct __vol_uuid__
+{
+	char	uuid [64];
+	dev_t	dev;
+} VOL_UUID;
+
+typedef struct __vol_snap__
+{
+	int	refs,
+		nrecs,
+		nuuids;
+
+	unsigned long long stamp;	/* CLOCK_MONOTONIC_COARSE, nsecs	*/
+
+	VOL_REC	*recs;			/* Sorted by dev		*/
+	VOL_UUID *uuids;		/* Sorted by uuid		*/
+} VOL_SNAP;
+
+static	pthread_mutex_t	vol$lock = PTHREAD_MUTEX_INITIALIZER;
+static	VOL_SNAP	*vol$snap;
+
+static	int	_vol_cmpdev	(const void *a, const void *b)
+{
+dev_t	d1 = ((const VOL_REC *) a)->dev, d2 = ((const VOL_REC *) b)->dev;
+
+	return	(d1 > d2) - (d1 < d2);
+}
+
+static	int	_vol_cmpuuid	(const void *a, const void *b)
+{
+	return	strcasecmp(((const VOL_UUID *) a)->uuid, ((const VOL_UUID *) b)->uuid);
+}
+
+/* Read a sysfs attribute relative to the directory, trailing spaces are removed */
+static	int	_vol_attr	(
+		int	dfd,
+	const	char	*path,
+		char	*buf,
+		int	bufsz
 			)
 {
-int	status, qlog = opts & CLI$M_OPTRACE;
-CLI_CTX	*ctx;
-
-	$IFTRACE(qlog, "argc=%d, opts=%#x", argc, opts);
+int	fd, len;
 
-	/*
-	 * Sanity check for input arguments ...
-	 */
-	if ( argc < 1 )
-		return	(opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "Too many arguments") : STS$K_FATAL;
+	*buf = '\0';
 
-	/* Create CLI-context area */
-	if ( !(*clictx = calloc(1, sizeof(CLI_CTX))) )
-		return	(opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno) : STS$K_FATAL;
-	ctx = *clictx;
-	ctx->opts = opts;
+	if ( 0 > (fd = openat(dfd, path, O_RDONLY)) )
+		return	-1;
 
+	len = read(fd, buf, bufsz - 1);
+	close(fd);
 
-	status = _cli$parse_verb(*clictx, verbs, argc, argv);
+	for ( len = $MAX(len, 0); len && ((unsigned char) buf[len - 1] <= ' '); len--);
+	buf[len] = '\0';
 
-	return	STS$K_SUCCESS;
+	return	len;
 }
 
-/*
- *
- *  DESCRIPTION: retreive a value of the parameter or qualifier from the CLI-context has been created and filled by cli$parse().
-
- *  INPUT:
- *	ctx:	A CLI-context has been created by cli$parse()
- *	pq:	A pointer to parameter/qualifier definition
- *	val:	A buffer to accept value
- *
- *  RETURN:
- *	STS$K_WARN	- value is zero length
- *	SS$_NORMAL, condition status
- *
- */
-int	cli$get_value	(
-	CLI_CTX		*clictx,
-	CLI_PQDESC	*pq,
-		ASC	*val
+/* Get device's record from the previous snapshot, or read static attributes */
+static	int	_vol_fill	(
+		int	dfd,
+	const	char	*name,
+		VOL_REC	*rec,
+		VOL_REC	*parent,
+		VOL_SNAP *prev
 			)
 {
-CLI_ITEM *item;
+char	buf[64];
+unsigned maj, min;
+VOL_REC	*old;
 
-	/* Sanity check */
-	if ( !clictx )
-		return	$LOG(STS$K_FATAL, "CLI-context is empty");
+	memset(rec, 0, sizeof(VOL_REC));
 
-	if ( !pq )
-		return	$LOG(STS$K_FATAL, "Illegal parameter/qualifier definition");
+	if ( 0 >= _vol_attr(dfd, "dev", buf, sizeof(buf)) || (2 != sscanf(buf, "%u:%u", &maj, &min)) )
+		return	-1;
 
-	for ( item = clictx->avlist; item; item = item->next)
-		{
-		if ( pq  == item->pqdesc )
-			{
-			/* Do we need to return a qualifier value to caller ?*/
-			if ( val )
-				{
-				*val = item->val;
+	rec->dev = makedev(maj, min);
 
-				if ( !($ASCLEN(val)) )
-					return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_WARN, "Zero length value") : STS$K_WARN;
-				}
+	/* Static attributes are taken from the cache by device number */
+	if ( prev && (old = bsearch(rec, prev->recs, prev->nrecs, sizeof(VOL_REC), _vol_cmpdev)) && !strcmp(old->name, name) )
+		{
+		*rec = *old;
+		rec->uuid[0] = '\0';
+		}
+	else	{
+		snprintf(rec->name, sizeof(rec->name), "%s", name);
+		rec->partition = (parent != NULL);
 
-			return	STS$K_SUCCESS;
+		if ( parent )
+			{
+			rec->removable = parent->removable;
+			rec->rotational = parent->rotational;
+			memcpy(rec->model, parent->model, sizeof(rec->model));
+			}
+		else	{
+			rec->removable = (0 < _vol_attr(dfd, "removable", buf, sizeof(buf))) && atoi(buf);
+			rec->rotational = (0 < _vol_attr(dfd, "queue/rotational", buf, sizeof(buf))) && atoi(buf);
+			_vol_attr(dfd, "device/model", rec->model, sizeof(rec->model));
 			}
-
 		}
 
-	return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_ERROR, "No parameter/qualifier ('%.*s') is present in command line",
-						       $ASC(&pq->name)) : STS$K_ERROR;
-}
+	/* Size and RO state can be changed at any time */
+	rec->sectors = (0 < _vol_attr(dfd, "size", buf, sizeof(buf))) ? strtoull(buf, NULL, 10) : 0;
+	rec->ro = (0 < _vol_attr(dfd, "ro", buf, sizeof(buf))) && atoi(buf);
 
+	return	0;
+}
 
-/*
- *
- *  DESCRIPTION: release resources has been allocated by cli$parse() routine.
- *
- *  INPUT:
- *	ctx:	A CLI-context has been created by cli$parse()
- *
- *  RETURN:
- *	SS$_NORMAL, condition status
- *
- */
-int	cli$cleanup	(
-		CLI_CTX	*clictx
-		)
+static	int	_vol_push	(
+		VOL_SNAP *snap,
+		int	*cap
+			)
 {
+VOL_REC	*recs;
 
-CLI_ITEM	*avp, *avp2;
+	if ( snap->nrecs < *cap )
+		return	0;
 
-	/* Run over verb's items list and free has been alocated memory ...*/
-	for (avp = clictx->vlist; avp; )
-		{
-		avp2 = avp;
-		avp = avp->next;
-		free(avp2);
-		}
+	*cap = $MAX(*cap * 2, 256);
 
-	/* Run over vlaue's items list and free has been alocated memory ...*/
-	for (avp = clictx->avlist; avp; )
-		{
-		avp2 = avp;
-		avp = avp->next;
-		free(avp2);
-		}
+	if ( !(recs = realloc(snap->recs, *cap * sizeof(VOL_REC))) )
+		return	-1;
 
-	/* Release CLI-context area */
-	free(clictx);
+	snap->recs = recs;
 
-	return	STS$K_SUCCESS;
+	return	0;
 }
 
+static	void	_vol_release	(
+		VOL_SNAP *snap
+			)
+{
+	if ( !snap || __atomic_sub_fetch(&snap->refs, 1, __ATOMIC_ACQ_REL) )
+		return;
 
-/*
- *
- *  DESCRIPTION: dispatch processing to action routine has been defined for the last verb's keyword.
- *
- *  INPUT:
- *	ctx:	A CLI-context has been created by cli$parse()
- *
- *  RETURN:
- *	SS$_NORMAL, condition status
- *
- */
-int	cli$dispatch	(
-		CLI_CTX	*clictx
+	free(snap->recs);
+	free(snap->uuids);
+	free(snap);
+}
+
+/* Scan /sys/block and /dev/disk/by-uuid into a new snapshot */
+static	VOL_SNAP *_vol_scan	(
+		VOL_SNAP *prev
 			)
 {
-CLI_ITEM	*item;
-CLI_VERB	*verb;
+VOL_SNAP	*snap;
+VOL_REC		key, *rec;
+DIR		*dp, *pdp;
+struct dirent	*de, *pde;
+struct stat	st;
+int		dfd, ddfd, pfd, cap = 0, ucap = 0, disk;
+size_t		len;
+char		buf[16];
+VOL_UUID	*uuids;
+
+	if ( !(snap = calloc(1, sizeof(VOL_SNAP))) )
+		return	NULL;
+
+	snap->refs = 1;
+
+	if ( (0 <= (dfd = open("/sys/block", O_RDONLY | O_DIRECTORY))) && (dp = fdopendir(dfd)) )
+		{
+		while ( (de = readdir(dp)) )
+			{
+			if ( (de->d_name[0] == '.') || (0 > (ddfd = openat(dfd, de->d_name, O_RDONLY | O_DIRECTORY))) )
+				continue;
 
-	/* Run over verb's items to last element */
-	for ( item = clictx->vlist; item && item->next; item = item->next);
+			if ( _vol_push(snap, &cap) || _vol_fill(ddfd, de->d_name, &snap->recs[snap->nrecs], NULL, prev) )
+				{
+				close(ddfd);
+				continue;
+				}
 
-	if ( !item )
-		return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "No verb's item has been found in CLI-context") : STS$K_FATAL;
+			disk = snap->nrecs++;
 
-	if ( !(verb = item->verb)  )
-		return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_FATAL, "No verb has been found in CLI-context") : STS$K_FATAL;
+			/* Partitions are subdirectories have a 'partition' attribute */
+			if ( (0 <= (pfd = dup(ddfd))) && (pdp = fdopendir(pfd)) )
+				{
+				while ( (pde = readdir(pdp)) )
+					{
+					if ( pde->d_name[0] == '.' )
+						continue;
 
-	$IFTRACE(clictx->opts & CLI$M_OPTRACE, "Action routine=%#x, argument=%#x", verb->act_rtn, verb->act_arg);
+					if ( 0 > (pfd = openat(ddfd, pde->d_name, O_RDONLY | O_DIRECTORY)) )
+						continue;
 
-	if ( verb->act_rtn )
-		return	verb->act_rtn(clictx, verb->act_arg);
+					if ( (0 < _vol_attr(pfd, "partition", buf, sizeof(buf))) && !_vol_push(snap, &cap)
+						&& !_vol_fill(pfd, pde->d_name, &snap->recs[snap->nrecs], &snap->recs[disk], prev) )
+						snap->nrecs++;
 
-	return	(clictx->opts & CLI$M_OPSIGNAL) ? $LOG(STS$K_WARN, "No action routine has been defined") : STS$K_WARN;
+					close(pfd);
+					}
 
-}
+				closedir(pdp);
+				}
+			else if ( pfd >= 0 )
+				close(pfd);
 
+			close(ddfd);
+			}
 
+		closedir(dp);
+		}
+	else if ( dfd >= 0 )
+		close(dfd);
 
+	qsort(snap->recs, snap->nrecs, sizeof(VOL_REC), _vol_cmpdev);
 
-#ifdef	__CLI_DEBUG__
+	/* UUID index: a symlink's name is UUID, its target is a device node */
+	if ( (0 <= (dfd = open("/dev/disk/by-uuid", O_RDONLY | O_DIRECTORY))) && (dp = fdopendir(dfd)) )
+		{
+		while ( (de = readdir(dp)) )
+			{
+			if ( (de->d_name[0] == '.') || fstatat(dfd, de->d_name, &st, 0) || !S_ISBLK(st.st_mode) )
+				continue;
 
-#include	<stdio.h>
-#include	<errno.h>
+			/* A truncated name would be a bogus key, such names are not UUIDs anyway */
+			if ( (len = strlen(de->d_name)) >= sizeof(snap->uuids[0].uuid) )
+				continue;
 
+			if ( snap->nuuids == ucap )
+				{
+				ucap = $MAX(ucap * 2, 64);
 
-/*
-	SHOW	VOLUME	<p1-volume_name>/UUID=<uuid> /FULL
-		USER	<p1-user-name>  /FULL /GROUP=<user_group_name>
-		VM	<p1-VM-name>	/FULL /GROUP=<vm_group_name>
+				if ( !(uuids = realloc(snap->uuids, ucap * sizeof(VOL_UUID))) )
+					break;
 
-	DIFF	<p1-file-name> <p2-file-name> /BLOCK=(START=<lbn>, END=<lbn>, COUNT=<lbn>)
-			/IGNORE=(ERROR) /LOGGING=(FULL, TRACE, ERROR)
+				snap->uuids = uuids;
+				}
 
-*/
+			memcpy(snap->uuids[snap->nuuids].uuid, de->d_name, len + 1);
+			snap->uuids[snap->nuuids++].dev = st.st_rdev;
 
-enum	{
-	SHOW$K_VOLUME = 1,
-	SHOW$K_USER,
-	SHOW$K_VM
-};
+			key.dev = st.st_rdev;
 
+			if ( (rec = bsearch(&key, snap->recs, snap->nrecs, sizeof(VOL_REC), _vol_cmpdev)) )
+				memcpy(rec->uuid, de->d_name, len + 1);
+			}
 
-enum	{
-	DIFF$K_FULL = 1,
-	DIFF$K_TRACE = 1,
-	DIFF$K_ERROR = 1
-};
+		closedir(dp);
+		}
+	else if ( dfd >= 0 )
+		close(dfd);
 
-CLI_KEYWORD	diff_log_opts[] = {
-			{ .name = {$ASCINI("FULL")},	.val = DIFF$K_FULL},
-			{ .name = {$ASCINI("TRACE")},	.val = DIFF$K_TRACE},
-			{ .name = {$ASCINI("ERROR")},	.val = DIFF$K_ERROR},
-			{0}},
+	qsort(snap->uuids, snap->nuuids, sizeof(VOL_UUID), _vol_cmpuuid);
 
-		show_what_opts [] = {
-			{ .name = {$ASCINI("VOLUME")},	.val = SHOW$K_VOLUME},
-			{ .name = {$ASCINI("USER")},	.val = SHOW$K_USER},
-			{ .name = {$ASCINI("VM")},	.val = SHOW$K_VM},
-			{0}};
+	snap->stamp = _cli$now(CLOCK_MONOTONIC_COARSE);
 
-CLI_PQDESC	diff_quals [] = {
-			{ .name = {$ASCINI("START")},	.type = CLI$K_NUM},
-			{ .name = {$ASCINI("END")},	.type = CLI$K_NUM},
-			{ .name = {$ASCINI("COUNT")},	.type = CLI$K_NUM},
-			{ .name = {$ASCINI("IGNORE")},	.type = CLI$K_OPT},
-			{ .name = {$ASCINI("LOGGING")}, .type = CLI$K_KWD, .kwd = diff_log_opts},
-			{0}},
+	return	snap;
+}
 
-		show_volume_quals [] = {
-			{ .name = {$ASCINI("UUID")},	CLI$K_UUID},
-			{ .name = {$ASCINI("FULL")},	CLI$K_OPT},
-			{0}},
-		show_user_quals [] = {
-			{ .name = {$ASCINI("GROUP")},	CLI$K_QSTRING},
-			{ .name = {$ASCINI("FULL")},	CLI$K_OPT},
-			{0}},
-		show_vm_quals [] = {
-			{ .name = {$ASCINI("GROUP")},	CLI$K_QSTRING},
-			{ .name = {$ASCINI("FULL")},	CLI$K_OPT},
-			{0}};
+/* Get a current snapshot by reference, rescan if it's expired */
+static	VOL_SNAP *_vol_snapshot	(void)
+{
+VOL_SNAP	*snap;
 
-CLI_PQDESC	diff_params [] = {
-			{.pn = CLI$K_P1, .type = CLI$K_FILE, .name = {$ASCINI("Input file 1")} },
-			{.pn = CLI$K_P2, .type = CLI$K_FILE, .name = {$ASCINI("Input file 2")} },
-			{0}},
+	pthread_mutex_lock(&vol$lock);
 
-		show_volume_params [] = {
-			{.pn = CLI$K_P1, .type = CLI$K_DEVICE, .name = {$ASCINI("Volume name (eg: sdb, sdb1, sda5: )")} },
-			{0}},
+	if ( !vol$snap || (vol$snap->stamp + VOL$K_TTL * 1000000ULL <= _cli$now(CLOCK_MONOTONIC_COARSE)) )
+		{
+		if ( (snap = _vol_scan(vol$snap)) )
+			{
+			_vol_release(vol$snap);
+			vol$snap = snap;
+			}
+		}
 
-		show_user_params [] = {
-			{.pn = CLI$K_P1, .type = CLI$K_QSTRING,  .name = {$ASCINI("User spec")}},
-			{0}},
+	if ( (snap = vol$snap) )
+		__atomic_add_fetch(&snap->refs, 1, __ATOMIC_ACQ_REL);
 
-		show_vm_params [] = {
-			{.pn = CLI$K_P1, .type = CLI$K_QSTRING,  .name = {$ASCINI("VM Id")}},
-			{0}};
+	pthread_mutex_unlock(&vol$lock);
 
+	return	snap;
+}
 
-int	diff_action	( CLI_CTX *clictx, void *arg);
-int	show_action	( CLI_CTX *clictx, void *arg);
+static	int	show_volume	( CLI_CTX *clictx)
+{
+int	status = STS$K_SUCCESS, full, ncols, i, n;
+ASC	val;
+char	spec[ASC$K_SZ + 1] = "*", majmin[32], size[32], *cp;
+const char *hdr[] = {"NAME", "MAJ:MIN", "SIZE(MB)", "TYPE", "RO", "RM", "ROTA", "MODEL", "UUID"}, *rec[9];
+const int widths[] = {16, 8, 10, 4, 2, 2, 4, 24, 0};
+VOL_SNAP *snap;
+VOL_REC	*vp, key;
+VOL_UUID ukey, *up = NULL;
+
+	if ( 1 & cli$get_value(clictx, &show_volume_params[0], &val) )
+		{
+		show_value(&val, spec);
 
-CLI_VERB	show_what []  = {
-	{ {$ASCINI("volume")},	.params = show_volume_params, .quals = show_volume_quals , .act_rtn = show_action, .act_arg = SHOW$K_VOLUME },
-	{ {$ASCINI("vm")},	.params = show_user_params, .quals = show_vm_quals,  .act_rtn = show_action, .act_arg = SHOW$K_VM  },
-	{ {$ASCINI("user")},	.params = show_vm_params, .quals = show_user_quals , .act_rtn = show_action, .act_arg = SHOW$K_USER  },
-	{0}};
+		if ( (cp = strstr(spec, "dev/")) )
+			memmove(spec, cp + 4, strlen(cp + 4) + 1);
+		}
 
+	if ( !(snap = _vol_snapshot()) )
+		return	$LOG(STS$K_FATAL, "Cannot allocate memory, errno=%d", errno);
 
-CLI_VERB	top_commands []  = {
-	{ .name = {$ASCINI("diff")}, .params = diff_params, .quals = diff_quals , .act_rtn = diff_action  },
-	{ .name = {$ASCINI("show")}, .next = show_what},
-	{0}};
+	/* /UUID is looked up by the index */
+	if ( 1 & cli$get_value(clictx, &show_volume_quals[0], &val) )
+		{
+		if ( $ASCLEN(&val) >= sizeof(ukey.uuid) )
+			{
+			_vol_release(snap);
+			return	$LOG(STS$K_ERROR, "No volume with UUID '%.*s' has been found", $ASC(&val));
+			}
 
-ASC	prompt = {$ASCINI("CRYPTORCP>")};
+		show_value(&val, ukey.uuid);
 
+		if ( !(up = bsearch(&ukey, snap->uuids, snap->nuuids, sizeof(VOL_UUID), _vol_cmpuuid)) )
+			{
+			_vol_release(snap);
+			return	$LOG(STS$K_ERROR, "No volume with UUID '%s' has been found", ukey.uuid);
+			}
+		}
 
-int	diff_action	(
-		CLI_CTX		*clictx,
-			void	*arg
-			)
+	full = (1 & cli$get_value(clictx, &show_volume_quals[1], NULL));
+	ncols = full ? 9 : 4;
+
+	if ( !(1 & (status = cli$put_header(clictx, ncols, hdr, widths))) )
+		{
+		_vol_release(snap);
+		return	status;
+		}
+
+	if ( up )
+		{
+		key.dev = up->dev;
+		vp = bsearch(&key, snap->recs, snap->nrecs, sizeof(VOL_REC), _vol_cmpdev);
+		i = vp ? vp - snap->recs : snap->nrecs;
+		n = vp ? i + 1 : i;
+		}
+	else	i = 0, n = snap->nrecs;
+
+	for ( ; (1 & status) && (i < n); i++)
+		{
+		vp = &snap->recs[i];
+
+		if ( fnmatch(spec, vp->name, 0) )
+			continue;
+
+		snprintf(majmin, sizeof(majmin), "%u:%u", major(vp->dev), minor(vp->dev));
+		snprintf(size, sizeof(size), "%llu", vp->sectors / 2048);
+
+		rec[0] = vp->name;
+		rec[1] = majmin;
+		rec[2] = size;
+		rec[3] = vp->partition ? "part" : "disk";
+		rec[4] = vp->ro ? "1" : "0";
+		rec[5] = vp->removable ? "1" : "0";
+		rec[6] = vp->rotational ? "1" : "0";
+		rec[7] = vp->model;
+		rec[8] = vp->uuid;
+
+		status = cli$put_output(clictx, ncols, rec);
+		}
+
+	_vol_release(snap);
+
+	return	(1 & status) ? cli$flush_output(clictx) : status;
+}
+
+static	int	show_user	( CLI_CTX *clictx)
 {
-int	status;
-ASC	fl1, fl2;
+int	status, full, ncols;
+ASC	val;
+char	spec[ASC$K_SZ + 1] = "*", grname[ASC$K_SZ + 1], uid[32], gid[32];
+const char *hdr[] = {"USER", "UID", "GID", "HOME", "SHELL"}, *rec[5];
+const int widths[] = {16, 8, 8, 32, 0};
+struct passwd *pw;
+struct group *gr = NULL;
 
-	$IFTRACE(clictx->opts & CLI$M_OPTRACE, "Action routine is just called!");
+	if ( 1 & cli$get_value(clictx, &show_user_params[0], &val) )
+		show_value(&val, spec);
 
-	status = cli$get_value(clictx, &diff_params, &fl1);
+	if ( 1 & cli$get_value(clictx, &show_user_quals[0], &val) )
+		{
+		if ( !(gr = getgrnam(show_value(&val, grname))) )
+			return	$LOG(STS$K_ERROR, "No group '%s' has been found", grname);
+		}
 
-	status = cli$get_value(clictx, &diff_params, &fl2);
+	full = (1 & cli$get_value(clictx, &show_user_quals[1], NULL));
+	ncols = full ? 5 : 3;
 
-	$IFTRACE(clictx->opts & CLI$M_OPTRACE, "Comparing %.*s vs %.*s", $ASC(&fl1), $ASC(&fl2));
+	if ( !(1 & (status = cli$put_header(clictx, ncols, hdr, widths))) )
+		return	status;
+
+	/* Every record is buffered by the output sink, it's written by large batches */
+	for ( setpwent(); (pw = getpwent()); )
+		{
+		if ( fnmatch(spec, pw->pw_name, 0) || (gr && (gr->gr_gid != pw->pw_gid)) )
+			continue;
 
+		if ( !(1 & (status = cli$check_cancel(clictx))) )
+			break;
 
-	$IFTRACE(clictx->opts & CLI$M_OPTRACE, "Action routine has been completed!");
+		snprintf(uid, sizeof(uid), "%u", (unsigned) pw->pw_uid);
+		snprintf(gid, sizeof(gid), "%u", (unsigned) pw->pw_gid);
 
-	return	STS$K_SUCCESS;
+		rec[0] = pw->pw_name;
+		rec[1] = uid;
+		rec[2] = gid;
+		rec[3] = pw->pw_dir;
+		rec[4] = pw->pw_shell;
+
+		if ( !(1 & (status = cli$put_output(clictx, ncols, rec))) )
+			break;
+		}
+
+	endpwent();
+
+	return	(1 & status) ? cli$flush_output(clictx) : status;
 }
 
 int	show_action	( CLI_CTX *clictx, void *arg)
@@ -918,10 +7792,10 @@ ASC	val;
 	switch	( what )
 		{
 		case	SHOW$K_VOLUME:
-			break;
+			return	show_volume(clictx);
 
 		case	SHOW$K_USER:
-			break;
+			return	show_user(clictx);
 
 		case	SHOW$K_VM:
 			break;
@@ -959,6 +7833,9 @@ void	*clictx = NULL;
 	if ( !(1 & (status = cli$parse (top_commands, CLI$M_OPTRACE | CLI$M_OPSIGNAL, argc - 1, argv + 1, &clictx))) )
 		return	-EINVAL;
 
+	/* Records of the SHOW commands are buffered and written to the stdout */
+	cli$set_output (clictx, STDOUT_FILENO, CLI$K_OUT_TEXT);
+
 	/* Show  a result of the parsing */
 	cli$show_ctx (clictx);
 
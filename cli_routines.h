@@ -64,7 +64,8 @@ extern "C" {
 
 
 #define	CLI$M_NEGATABLE	1	/* Qualifier can be negatable	*/
-#define	CLI$M_LIST	2
+#define	CLI$M_LIST	2	/* A list of values: "a,b,c", "@file" or "@-" (stdin),	*/
+				/* every element is checked at cli$list_next()		*/
 #define	CLI$M_PRESENT	4
 
 #define	CLI$S_MAXVERBL	32	/* Maximum verb's length	*/
@@ -88,7 +89,7 @@ typedef	struct __cli_pqdesc__	{
 
 	unsigned short	type;	/* FILE, DATE ...		*/
 	unsigned char	pn;	/* P1, P2, ... P8		*/
-	unsigned char	flag;	/* Reserved			*/
+	unsigned char	flag;	/* CLI$M_LIST			*/
 
 	ASC		defval;	/* Default value string		*/
 
@@ -107,13 +108,40 @@ typedef	struct __cli__verb__	{
 	int	(*act_rtn) (__unknown_params);
 	void	*act_arg;
 
+	char	*shlib;	/* A shared object to be dlopen'ed at first use	*/
+	char	*shsym;	/* A name of the CLI_VERB record in the shared	*/
+			/* object, default is CLI$T_PLUGSYM		*/
+	int	bound;	/* Set in a bound copy, a stub is never changed	*/
+
+	int	flags;	/* CLI$M_VERB_* options				*/
+	int	ttl;	/* Result cache's TTL, msecs, 0 - CLI$K_CACHETTL*/
+
+	int	sched;	/* Scheduling class, CLI$K_SCHED_*		*/
+	int	cost;	/* Relative cost hint, 0 - 1			*/
 } CLI_VERB;
 
+/* Scheduling classes of the verbs, see cli$sched_*() */
+enum	{
+	CLI$K_SCHED_NORMAL = 0,
+	CLI$K_SCHED_INTERACTIVE,	/* Operator's short commands		*/
+	CLI$K_SCHED_BATCH,		/* Long running heavy commands		*/
+	CLI$K_SCHED_CLASSES
+};
+
+/* Verb's options */
+#define	CLI$M_VERB_IDEMPOTENT	1	/* An output of the verb depends only on	*/
+					/* the command line, it's cached for TTL	*/
+
+#define	CLI$T_PLUGSYM	"cli$plugin"
+
 typedef	struct	__cli_item__{
 	struct	__cli_item__ *next;/* Linked list stuff	*/
 
 	unsigned	type;	/* 0 - verb, P1 - P8, QUAL	*/
 
+	unsigned short	tokidx,	/* A position of the value in the	*/
+			tokoff;	/* command line, see cli$validate()	*/
+
 	union	{
 		CLI_VERB	*verb;
 
@@ -135,15 +163,126 @@ typedef	struct	__cli_item__{
 /* Processing options		*/
 #define	CLI$M_OPTRACE	1
 #define	CLI$M_OPSIGNAL	2
+#define	CLI$M_OPDEFERVAL 4	/* Values are not checked by cli$parse(),	*/
+				/* see cli$validate()				*/
+
+/*
+ * A reason of the parsing/checking failure, see CLI_ERR
+ */
+enum	{
+	CLI$K_ERR_NONE = 0,
+	CLI$K_ERR_NOVERB,	/* No command verb or subverb		*/
+	CLI$K_ERR_AMBIGUOUS,	/* Ambiguous verb, qualifier or keyword	*/
+	CLI$K_ERR_UNRECOGNIZED,	/* Unrecognized verb, qualifier or keyword */
+	CLI$K_ERR_MISSING,	/* Missing parameter			*/
+	CLI$K_ERR_BADVALUE,	/* Value doesn't match declared type	*/
+	CLI$K_ERR_NOMEM,	/* Insufficient memory			*/
+	CLI$K_ERR_MAXARGC,	/* Too many arguments, see CLI_LIMITS	*/
+	CLI$K_ERR_MAXBYTES,	/* Command line is too long		*/
+	CLI$K_ERR_PLUGIN,	/* Verb's shared object cannot be bound	*/
+	CLI$K_ERR_MEMLIMIT,	/* Memory limit has been exceeded	*/
+	CLI$K_ERR_TIMEOUT,	/* Command's deadline has been expired	*/
+	CLI$K_ERR_CANCELLED,	/* Command has been cancelled		*/
+	CLI$K_ERR_OUTPUT	/* Output sink I/O error		*/
+};
+
+/*
+ * A structured error record is filled on failure without any formatting,
+ * use cli$format_error() to get a message text.
+ */
+typedef struct __cli_err__
+{
+	int	sts,		/* Condition status			*/
+		reason,		/* CLI$K_ERR_*				*/
+		tokidx,		/* An index of the offending argument	*/
+		offset,		/* A byte offset of the offending text in the	*/
+				/* command line (arguments are joined by ' ')	*/
+		errnum;		/* errno, if any			*/
+
+	unsigned dtype;		/* 0 - verb, P1 - P8, QUAL, KWD		*/
+	void	*desc,		/* Offending verb/param/qual/keyword	*/
+		*alt;		/* Second match for CLI$K_ERR_AMBIGUOUS	*/
+
+	ASC	text;		/* Offending text			*/
+} CLI_ERR;
+
+/*
+ * Memory accounting of the CLI-context and all contexts (global)
+ */
+typedef struct __cli_mstat__
+{
+	unsigned long long	bytes,	/* Currently allocated octets	*/
+				items,	/* Currently allocated items	*/
+				peak,	/* Peak of the 'bytes'		*/
+				nalloc;	/* Total number of allocations	*/
+} CLI_MSTAT;
+
+typedef struct __cli_out__	CLI_OUT;	/* Output sink, see cli$set_output() */
+typedef struct __cli_ctxpool__	CLI_CTXPOOL;	/* Context pool, see cli$ctx_pool() */
 
 typedef struct __cli_ctx__
 {
 	int	opts;
 
 	CLI_ITEM	*vlist,	/* A list of verbs' sequence for a command */
-			*avlist;/* A list of parameters' values and qualifiers */
+			*avlist,/* A list of parameters' values and qualifiers */
+			*vtail,	/* Last items of the lists above	*/
+			*avtail;
+
+	int	argc,		/* Arguments are being parsed		*/
+		tokidx,		/* A current argument and offset in it	*/
+		tokoff;
+	char	**argv;
+
+	CLI_ERR	err;		/* Last error				*/
+
+	CLI_MSTAT mstat;	/* Memory accounting			*/
+
+	unsigned long long deadline;	/* CLOCK_MONOTONIC, nsecs, 0 - none	*/
+	int	cancel,		/* CLI$K_CANCEL_* state, atomic		*/
+		refs,		/* Extra references (abandoned dispatch)*/
+		errbusy;	/* Writers of the error record, atomic	*/
+
+	CLI_OUT	*out;		/* Output sink, NULL - records go to $LOG */
+
+	void	*rec;		/* Pending record of the traffic log	*/
+
+	CLI_CTXPOOL *pool;	/* Owner pool, NULL - heap		*/
+	CLI_ITEM *items;	/* Preallocated items of the pooled context */
+	int	nitems,		/* Used preallocated items		*/
+		maxitems;
 } CLI_CTX;
 
+/* Cancellation state of the CLI-context */
+enum	{
+	CLI$K_CANCEL_NONE = 0,
+	CLI$K_CANCEL_REQ,	/* Cancellation has been requested	*/
+	CLI$K_CANCEL_ABANDON	/* Dispatcher doesn't wait the command	*/
+};
+
+/* cli$dispatch_timed() options */
+#define	CLI$M_DSP_ABANDON	1	/* Run action routine in a separate	*/
+					/* thread, return at the deadline	*/
+
+/*
+ * Limits are applied by cli$parse() to reject oversized input before any processing,
+ * a zero value means no limit.
+ */
+#define	CLI$K_MAXARGC	1024		/* Default maximum number of arguments		*/
+#define	CLI$K_MAXBYTES	(64 * 1024)	/* Default maximum total length of arguments	*/
+
+typedef struct __cli_limits__
+{
+	int	maxargc,	/* Maximum number of arguments		*/
+		maxbytes;	/* Maximum total length of arguments	*/
+
+	unsigned long long ctxmem,	/* Maximum octets per CLI-context	*/
+			globmem;	/* Maximum octets for all contexts	*/
+
+	int	dsptmo;		/* Default deadline of cli$dispatch(),	*/
+				/* msecs, 0 - no limit			*/
+} CLI_LIMITS;
+
 
 
 /*
@@ -154,6 +293,341 @@ int	cli$parse	(CLI_VERB *verbs, int opts, int	argc, char ** argv, void **clictx)
 int	cli$dispatch	(CLI_CTX *clictx);
 int	cli$cleanup	(CLI_CTX *clictx);
 int	cli$get_value	(CLI_CTX *clictx, CLI_PQDESC *pq, ASC *val);
+int	cli$validate	(CLI_CTX *clictx);
+
+/*
+ * A streaming iterator over elements of the list-valued (CLI$M_LIST) parameter or qualifier,
+ * a response file is memory-mapped (or read by chunks for stdin and pipes), the list is never held
+ * in the context. On the element's checking failure an index of the element is in the CLI_ERR.tokidx.
+ */
+typedef struct __cli_list__	CLI_LIST;
+
+int	cli$list_open	(CLI_CTX *clictx, CLI_PQDESC *pq, CLI_LIST **list);
+int	cli$list_next	(CLI_LIST *list, ASC *val);
+int	cli$list_close	(CLI_LIST *list);
+int	cli$format_error(CLI_CTX *clictx, char *buf, int bufsz);
+int	cli$set_limits	(CLI_LIMITS *limits);
+int	cli$get_limits	(CLI_LIMITS *limits);
+int	cli$get_memstat	(CLI_CTX *clictx, CLI_MSTAT *mstat);
+
+/*
+ * Context pool for server workloads: cli$parse() takes contexts with preallocated items from
+ * a per-thread cache backed by a lock-free global freelist of the attached pool, cli$cleanup()
+ * returns them back. A command with more than 'nitems' items takes extra items from the heap,
+ * a context is allocated from the heap when the pool is exhausted.
+ * Contexts cached by threads are returned to their pool at switching to other pool or thread's exit,
+ * cli$ctx_pool_free() fails while contexts of the pool are still in use, it can be called while
+ * other threads are parsing.
+ */
+#define	CLI$K_POOLCACHE	16	/* Contexts are cached per thread	*/
+
+typedef struct __cli_poolstat__
+{
+	unsigned long long	ctxs,	/* Contexts in the pool			*/
+				refills,/* Thread's cache has been refilled	*/
+				flushes,/* Thread's cache has been flushed	*/
+				misses;	/* The pool has been exhausted		*/
+} CLI_POOLSTAT;
+
+int	cli$ctx_pool_init (CLI_CTXPOOL **pool, int nctxs, int nitems);
+int	cli$ctx_pool	(CLI_CTXPOOL *pool);
+int	cli$ctx_pool_stat (CLI_CTXPOOL *pool, CLI_POOLSTAT *stat);
+int	cli$ctx_pool_free (CLI_CTXPOOL *pool);
+
+/*
+ * Deadlines and cooperative cancellation: long running action routines should poll
+ * cli$check_cancel() and return its status when it's not successfull.
+ */
+int	cli$set_deadline(CLI_CTX *clictx, int msecs);
+int	cli$cancel	(CLI_CTX *clictx);
+int	cli$check_cancel(CLI_CTX *clictx);
+int	cli$dispatch_timed (CLI_CTX *clictx, int msecs, int flags);
+
+/*
+ * Buffered structured output: records are accumulated in the context's buffer and written
+ * by writev() (sendmsg() for sockets) in large batches. A record is a set of columns
+ * has been declared by cli$put_header(), rendered as a text table, CSV or JSON array.
+ */
+enum	{
+	CLI$K_OUT_TEXT = 0,	/* Text table, columns are padded	*/
+	CLI$K_OUT_CSV,		/* RFC 4180 CSV with a header line	*/
+	CLI$K_OUT_JSON		/* JSON array of objects		*/
+};
+
+#define	CLI$K_OUTCOLS	32	/* Maximum number of columns		*/
+#define	CLI$S_OUTCHUNK	(64*1024)	/* A size of the buffer's chunk	*/
+#define	CLI$K_OUTIOV	8	/* Chunks are written by single call	*/
+
+int	cli$set_output	(CLI_CTX *clictx, int fd, int fmt);
+int	cli$put_header	(CLI_CTX *clictx, int ncols, const char **names, const int *widths);
+int	cli$put_output	(CLI_CTX *clictx, int nvals, const char **vals);
+int	cli$flush_output(CLI_CTX *clictx);
+
+/*
+ * Result cache of the idempotent verbs: a sink's output of the command is cached by the verb path
+ * and normalized parameters/qualifiers values, identical commands in flight are executed once.
+ */
+#define	CLI$K_CACHETTL	1000		/* Default TTL, msecs			*/
+#define	CLI$K_CACHEMAX	1024		/* Maximum number of cached results	*/
+#define	CLI$S_CACHEOBJ	(1024*1024)	/* Maximum size of the cached output	*/
+
+typedef struct __cli_cachestat__
+{
+	unsigned long long	hits,	/* Served from the cache		*/
+				misses,	/* Action routine has been called	*/
+				coalesced,/* Have waited for identical command	*/
+				entries;/* Currently cached results		*/
+} CLI_CACHESTAT;
+
+int	cli$cache_invalidate (char *path);
+int	cli$cache_stat	(CLI_CACHESTAT *stat);
+
+/*
+ * Priority-class scheduler: commands are queued per verb's scheduling class, a pool of workers
+ * picks classes by weighted fair queuing on the verbs' cost, a part of workers is reserved for
+ * the interactive class.
+ */
+typedef struct __cli_sched__	CLI_SCHED;
+
+typedef struct __cli_schedcfg__
+{
+	int	nworkers,	/* A number of worker threads		*/
+		reserved,	/* Workers are reserved for interactive	*/
+		weights [CLI$K_SCHED_CLASSES];	/* Shares, 0 - default	*/
+} CLI_SCHEDCFG;
+
+typedef struct __cli_schedstat__
+{
+	struct	{
+		unsigned long long	depth,		/* Commands in queue	*/
+					submitted,
+					completed,
+					waitsum,	/* Queue wait, nsecs	*/
+					waitmax;
+	} cls [CLI$K_SCHED_CLASSES];
+
+	int	busy;		/* Workers are executing commands	*/
+} CLI_SCHEDSTAT;
+
+typedef	void	(*CLI_SCHEDAST) (CLI_CTX *clictx, int status, void *arg);
+
+int	cli$sched_init	(CLI_SCHED **sched, CLI_SCHEDCFG *cfg);
+int	cli$sched_submit(CLI_SCHED *sched, CLI_CTX *clictx, CLI_SCHEDAST ast, void *arg);
+int	cli$sched_stat	(CLI_SCHED *sched, CLI_SCHEDSTAT *stat);
+int	cli$sched_free	(CLI_SCHED *sched);
+
+/*
+ * Pipelined executor for batch ingestion: command lines are tokenized and parsed (CLI$M_OPDEFERVAL),
+ * validated, and dispatched by three threads are connected by bounded lock-free single-producer/
+ * single-consumer rings. Rings carry preallocated slots (line buffer, argv, tokens), a number of slots
+ * is the ring's depth, so cli$pipe_submit() blocks when the pipeline is full.
+ * cli$pipe_submit() must be called from a single thread.
+ */
+#define	CLI$K_PIPE_DEPTH	256	/* Default ring's depth, power of 2	*/
+
+enum	{
+	CLI$K_PIPE_PARSE = 0,	/* Tokenizing and matching		*/
+	CLI$K_PIPE_VALIDATE,	/* Checking of values			*/
+	CLI$K_PIPE_DISPATCH,	/* Action routine, completion routine	*/
+	CLI$K_PIPE_STAGES
+};
+
+typedef struct __cli_pipe__	CLI_PIPE;
+
+typedef struct __cli_pipecfg__
+{
+	int	depth,		/* Ring's depth, 0 - CLI$K_PIPE_DEPTH	*/
+		opts,		/* cli$parse() options, see CLI$M_OP*	*/
+		cpus [CLI$K_PIPE_STAGES];	/* CPU of the stage's thread,	*/
+					/* -1 - don't pin			*/
+} CLI_PIPECFG;
+
+typedef struct __cli_pipestat__
+{
+	struct	{
+		unsigned long long	items,	/* Commands have been processed	*/
+					busy,	/* Processing time, nsecs	*/
+					idle;	/* Waiting for input, nsecs	*/
+		int			util;	/* busy / elapsed, percents	*/
+	} stage [CLI$K_PIPE_STAGES];
+
+	unsigned long long	submitted,
+				stalls,		/* cli$pipe_submit() has waited	*/
+				stallns,	/* for a free slot, nsecs	*/
+				elapsed;	/* nsecs			*/
+} CLI_PIPESTAT;
+
+/*
+ * Completion routine is called by the dispatch thread for every submitted command, 'clictx' is NULL
+ * for empty lines, comments and commands cli$pipe_submit() has failed to queue (with the same status).
+ */
+typedef	void	(*CLI_PIPEAST) (CLI_CTX *clictx, int status, void *arg);
+
+int	cli$pipe_init	(CLI_PIPE **pipe, CLI_VERB *verbs, CLI_PIPECFG *cfg, CLI_PIPEAST ast);
+int	cli$pipe_submit	(CLI_PIPE *pipe, char *line, int len, void *arg);
+int	cli$pipe_stat	(CLI_PIPE *pipe, CLI_PIPESTAT *stat);
+int	cli$pipe_free	(CLI_PIPE *pipe);
+
+/*
+ * Record and replay of the command traffic: when recording is started, every command line
+ * with a timestamp and stages' timings is buffered and appended to a binary log at cli$cleanup().
+ * The log is: CLI$T_RECMAGIC, then records - CLI_RECHDR followed by 'argc' zero-terminated
+ * arguments, padded to 8 octets. cli$replay() feeds the log back and collects latencies.
+ */
+#define	CLI$T_RECMAGIC	"CLIREC01"	/* Log file's signature, 8 octets	*/
+
+#define	CLI$M_REC_DISPATCHED	1	/* cli$dispatch() has been called	*/
+
+typedef struct __cli_rechdr__
+{
+	unsigned	len,		/* A length of the record, padded	*/
+			argc;		/* Number of arguments			*/
+
+	int	opts,		/* cli$parse() options			*/
+		psts,		/* cli$parse() status			*/
+		dsts,		/* cli$dispatch() status		*/
+		flags;		/* CLI$M_REC_*				*/
+
+	unsigned long long tstamp,	/* CLOCK_REALTIME, nsecs		*/
+			tparse,		/* cli$parse() time, nsecs		*/
+			tdispatch;	/* cli$dispatch() time, nsecs		*/
+} CLI_RECHDR;
+
+/* Replay options */
+#define	CLI$M_REPLAY_PACED	1	/* Keep original intervals between commands	*/
+#define	CLI$M_REPLAY_DISPATCH	2	/* Call action routines, output is discarded	*/
+
+#define	CLI$K_LATHIST	64	/* Buckets of latency histogram: [2**i, 2**(i+1)) nsecs	*/
+
+enum	{
+	CLI$K_STAGE_PARSE = 0,
+	CLI$K_STAGE_DISPATCH,
+	CLI$K_STAGE_TOTAL,
+	CLI$K_STAGES
+};
+
+typedef struct __cli_latstat__
+{
+	unsigned long long	count,
+				sum,		/* nsecs			*/
+				max,
+				p50, p90, p99,	/* Upper bounds of buckets	*/
+				hist [CLI$K_LATHIST];
+} CLI_LATSTAT;
+
+typedef struct __cli_replaystat__
+{
+	unsigned long long	nrecs,		/* Commands have been replayed	*/
+				nmismatch,	/* Status differs from recorded	*/
+				elapsed,	/* Wall time, nsecs		*/
+				rate;		/* Commands per second		*/
+
+	CLI_LATSTAT	orig [CLI$K_STAGES],	/* As recorded			*/
+			replay [CLI$K_STAGES];	/* As replayed			*/
+} CLI_REPLAYSTAT;
+
+int	cli$record_start(char *fspec);
+int	cli$record_flush(void);
+int	cli$record_stop	(void);
+int	cli$replay	(CLI_VERB *verbs, int opts, char *fspec, int flags, CLI_REPLAYSTAT *stat);
+
+/*
+ * Help and schema rendering: the verbs tree is walked once into a single buffer,
+ * the result is cached by (verbs, version, format), so a repeated request is a memcpy.
+ * A caller must bump 'version' when the verbs tree is changed in place; binding of stubs
+ * and cli$tbl_*() updates invalidate the cache by themselves.
+ */
+enum	{
+	CLI$K_FMT_TEXT = 0,	/* Human readable help text		*/
+	CLI$K_FMT_JSON		/* JSON schema of verbs/params/quals	*/
+};
+
+#define	CLI$S_HELPCACHE	8	/* Number of cached rendered tables	*/
+
+int	cli$render_help	(CLI_VERB *verbs, unsigned version, int fmt, char *buf, int bufsz, int *retlen);
+
+
+/*
+ * Runtime-mutable command table: a snapshot of the verbs tree is published RCU-style,
+ * parser threads get a consistent snapshot by cli$tbl_enter() without locking and
+ * must keep it (cli$tbl_leave) until the CLI-context built against it is released.
+ * Writers are serialized, copy only a path from the root to the changed array and
+ * reclaim replaced arrays after a grace period.
+ *
+ * Path is a sequence of full verb names separated by spaces, e.g.: "show" or "show volume",
+ * an empty path is referring to the root table.
+ */
+#define	CLI$S_MAXDEPTH	8	/* Maximum depth of the verbs tree	*/
+
+typedef struct __cli_table__	CLI_TABLE;
+
+int	cli$tbl_init	(CLI_TABLE **tbl, CLI_VERB *verbs);
+int	cli$tbl_free	(CLI_TABLE *tbl);
+CLI_VERB *cli$tbl_enter	(CLI_TABLE *tbl, int *slot);
+void	cli$tbl_leave	(CLI_TABLE *tbl, int slot);
+unsigned cli$tbl_version(CLI_TABLE *tbl);
+int	cli$tbl_add_verb(CLI_TABLE *tbl, char *path, CLI_VERB *verb);
+int	cli$tbl_del_verb(CLI_TABLE *tbl, char *path);
+int	cli$tbl_add_qual(CLI_TABLE *tbl, char *path, CLI_PQDESC *qual);
+int	cli$tbl_del_qual(CLI_TABLE *tbl, char *path, char *qual);
+
+
+/*
+ * Incremental parser's session: keeps per-token state of the last parsed command line,
+ * at update only the changed tokens and the tokens after them are re-matched, a value is
+ * re-validated only if its text or its parameter/qualifier definition has been changed.
+ */
+#define	CLI$K_EXTRA	0xff	/* Token is not expected by the syntax	*/
+
+typedef	struct	__cli_tokstat__{
+	int		sts;	/* A status of matching and value's checking	*/
+	unsigned	type;	/* 0 - verb, P1 - P8, QUAL, EXTRA		*/
+
+	union	{
+		CLI_VERB	*verb;
+		CLI_PQDESC	*pqdesc;
+	};
+} CLI_TOKSTAT;
+
+typedef struct __cli_session__	CLI_SESSION;
+
+int	cli$ses_init	(CLI_SESSION **ses, CLI_VERB *verbs, int opts);
+int	cli$ses_update	(CLI_SESSION *ses, int argc, char **argv, int *first);
+int	cli$ses_token	(CLI_SESSION *ses, int idx, CLI_TOKSTAT *tok);
+int	cli$ses_free	(CLI_SESSION *ses);
+
+
+/*
+ * Dry-run validation of a command script: a file is split at line boundaries, every line is
+ * parsed and checked (but not dispatched) on a pool of threads, errors are returned in line order.
+ * Empty lines and comments ('!' at first non-blank position) are skipped.
+ */
+typedef struct __cli_valerr__
+{
+	unsigned long long	lineno;	/* A line number, starts from 1	*/
+	CLI_ERR			err;	/* An error record of the line	*/
+} CLI_VALERR;
+
+int	cli$validate_file	(CLI_VERB *verbs, int opts, char *fspec, int nthreads, CLI_VALERR **errs, int *nerrs);
+
+
+/*
+ * Command text lexer: splits a text into whitespace separated tokens (a double quoted text is not split)
+ * by 64 octets blocks. Vectorized kernel is selected at runtime.
+ */
+#define	CLI$K_LEX_AUTO		0	/* The best kernel for the CPU	*/
+#define	CLI$K_LEX_SCALAR	1
+#define	CLI$K_LEX_SSE2		2
+#define	CLI$K_LEX_AVX2		3
+
+typedef struct __cli_token__
+{
+	int		off,	/* An offset of the token in the text	*/
+			len;	/* A length of the token		*/
+} CLI_TOKEN;
+
+int	cli$lex		(char *buf, int len, CLI_TOKEN *toks, int maxtoks);
+int	cli$lex_set_kernel (int kind);
 
 #ifdef __cplusplus
     }
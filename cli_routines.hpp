@@ -0,0 +1,302 @@
+#ifndef	__CLI$ROUTINES_HPP__
+#define __CLI$ROUTINES_HPP__	1
+
+/*
+**++
+**
+**  FACILITY:  Command Language Interface (CLI) Routines
+**
+**  ABSTRACT: A header-only C++ layer over the CLI Routines API.
+**
+**  DESCRIPTION: cli::Context owns a result of the cli$parse() and releases it by cli$cleanup(),
+**	it's move-only. Values are returned as std::string_view pointing at the value stored in the
+**	CLI-context item, so accessors don't copy and don't allocate. Typed accessors get<T>()
+**	convert NUM, IPV4, IPV6, DATE and UUID values.
+**
+**	An action routine can be any callable object (e.g. lambda) bound to the verb by cli::bind(),
+**	the object is referenced by the verb's act_arg, so there is no type-erasure allocation:
+**
+**		static auto show = [] (cli::ContextView ctx) { ... return STS$K_SUCCESS; };
+**		cli::bind(top_commands[0], show);
+**
+**		cli::Context ctx(top_commands, argc - 1, argv + 1);
+**
+**		if ( 1 & ctx.status() )
+**			ctx.dispatch();
+**
+**  AUTHORS: Ruslan R. Laishev (RRL)
+**
+**  CREATION DATE:  19-OCT-2026
+**
+**  MODIFICATION HISTORY:
+**
+**--
+*/
+
+#ifndef	__unknown_params
+#define __unknown_params ...
+#endif
+
+#ifndef	__optional_params
+#define __optional_params ...
+#endif
+
+#include	<string_view>
+#include	<optional>
+#include	<array>
+#include	<ctime>
+#include	<cstring>
+#include	<cstdlib>
+#include	<cerrno>
+#include	<cstdio>
+#include	<type_traits>
+#include	<limits>
+#include	<arpa/inet.h>
+
+#include	"utility_routines.h"
+#include	"cli_routines.h"
+
+namespace cli {
+
+/* Binary UUID, see CLI$K_UUID */
+typedef	std::array<unsigned char, 16>	uuid;
+
+/*
+ * A non-owning view of the CLI-context, is passed to action routines
+ */
+class	ContextView
+{
+public:
+	ContextView	(CLI_CTX *clictx = nullptr) noexcept : ctx(clictx) {}
+
+	CLI_CTX	*raw	() const noexcept { return ctx; }
+	explicit operator bool () const noexcept { return ctx != nullptr; }
+
+	/* Last error record of the context */
+	const CLI_ERR	*error	() const noexcept { return ctx ? &ctx->err : nullptr; }
+
+	/* Format error message into the caller's buffer, see cli$format_error() */
+	int	message	(char *buf, int bufsz) const noexcept
+	{
+		return	ctx ? cli$format_error(ctx, buf, bufsz) : 0;
+	}
+
+	/* Return a stored item of the parameter/qualifier, nullptr - has not been specified */
+	const CLI_ITEM	*item	(const CLI_PQDESC &pq) const noexcept
+	{
+		for (CLI_ITEM *avp = ctx ? ctx->avlist : nullptr; avp; avp = avp->next)
+			if ( avp->pqdesc == &pq )
+				return	avp;
+
+		return	nullptr;
+	}
+
+	/* Parameter/qualifier has been specified (e.g. CLI$K_OPT qualifier) */
+	bool	present	(const CLI_PQDESC &pq) const noexcept
+	{
+		return	item(pq) != nullptr;
+	}
+
+	/* A value as is, it points into the CLI-context and is valid until the context is released */
+	std::optional<std::string_view>	value	(const CLI_PQDESC &pq) const noexcept
+	{
+		const CLI_ITEM *avp = item(pq);
+
+		if ( !avp )
+			return	std::nullopt;
+
+		return	std::string_view($ASCPTR(&avp->val), $ASCLEN(&avp->val));
+	}
+
+	/* A value converted to the type T, std::nullopt - not specified or cannot be converted */
+	template <typename T> std::optional<T>	get	(const CLI_PQDESC &pq) const noexcept
+	{
+		std::optional<std::string_view> sv = value(pq);
+		char	buf[ASC$K_SZ + 1];
+
+		if ( !sv || !sv->size() )
+			return	std::nullopt;
+
+		/* C routines below need a zero-terminated string, make it on the stack */
+		std::memcpy(buf, sv->data(), sv->size());
+		buf[sv->size()] = '\0';
+
+		return	convert<T>(buf);
+	}
+
+protected:
+	CLI_CTX	*ctx;
+
+private:
+	/* CLI$K_NUM - decimal, octal, hex */
+	template <typename T> static std::enable_if_t<std::is_integral_v<T>, std::optional<T>> convert (const char *sts) noexcept
+	{
+		char	*cp;
+
+		errno = 0;
+
+		if constexpr ( std::is_signed_v<T> )
+			{
+			long long v = std::strtoll(sts, &cp, 0);
+
+			if ( errno || *cp || (v < (long long) std::numeric_limits<T>::min()) || (v > (long long) std::numeric_limits<T>::max()) )
+				return	std::nullopt;
+
+			return	(T) v;
+			}
+		else	{
+			unsigned long long v = std::strtoull(sts, &cp, 0);
+
+			if ( errno || *cp || (v > (unsigned long long) std::numeric_limits<T>::max()) )
+				return	std::nullopt;
+
+			return	(T) v;
+			}
+	}
+
+	/* CLI$K_IPV4, CLI$K_IPV6 */
+	template <typename T> static std::enable_if_t<std::is_same_v<T, struct in_addr> || std::is_same_v<T, struct in6_addr>, std::optional<T>>
+		convert (const char *sts) noexcept
+	{
+		T	addr;
+
+		if ( 1 != inet_pton(std::is_same_v<T, struct in_addr> ? AF_INET : AF_INET6, sts, &addr) )
+			return	std::nullopt;
+
+		return	addr;
+	}
+
+	/* CLI$K_DATE - dd-mm-yyyy[-hh:mm:ss] */
+	template <typename T> static std::enable_if_t<std::is_same_v<T, struct tm>, std::optional<T>> convert (const char *sts) noexcept
+	{
+		struct tm _tm = {};
+		char	sep;
+
+		if ( 3 > std::sscanf(sts, "%2d-%2d-%4d%c%2d:%2d:%2d", &_tm.tm_mday, &_tm.tm_mon, &_tm.tm_year,
+				&sep, &_tm.tm_hour, &_tm.tm_min, &_tm.tm_sec) )
+			return	std::nullopt;
+
+		_tm.tm_mon -= 1;
+		_tm.tm_year -= 1900;
+		_tm.tm_isdst = -1;
+
+		return	_tm;
+	}
+
+	/* CLI$K_UUID - xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx */
+	template <typename T> static std::enable_if_t<std::is_same_v<T, uuid>, std::optional<T>> convert (const char *sts) noexcept
+	{
+		uuid	u;
+		int	i, hi, lo;
+
+		for (i = 0; i < 16; i++)
+			{
+			if ( (i == 4) || (i == 6) || (i == 8) || (i == 10) )
+				{
+				if ( *sts++ != '-' )
+					return	std::nullopt;
+				}
+
+			if ( (0 > (hi = hexval(*sts++))) || (0 > (lo = hexval(*sts++))) )
+				return	std::nullopt;
+
+			u[i] = (unsigned char) ((hi << 4) | lo);
+			}
+
+		if ( *sts )
+			return	std::nullopt;
+
+		return	u;
+	}
+
+	static	int	hexval	(char c) noexcept
+	{
+		if ( (c >= '0') && (c <= '9') )
+			return	c - '0';
+		if ( (c >= 'a') && (c <= 'f') )
+			return	c - 'a' + 10;
+		if ( (c >= 'A') && (c <= 'F') )
+			return	c - 'A' + 10;
+
+		return	-1;
+	}
+};
+
+/*
+ * An owner of the parsed command, the context is released by cli$cleanup() at destruction
+ */
+class	Context : public ContextView
+{
+public:
+	Context	(CLI_VERB *verbs, int argc, char **argv, int opts = 0) noexcept
+	{
+		void	*clictx = nullptr;
+
+		sts = cli$parse(verbs, opts, argc, argv, &clictx);
+		ctx = (CLI_CTX *) clictx;
+	}
+
+	Context	(Context &&src) noexcept : ContextView(src.ctx), sts(src.sts)
+	{
+		src.ctx = nullptr;
+	}
+
+	Context	&operator= (Context &&src) noexcept
+	{
+		if ( this != &src )
+			{
+			release();
+			ctx = src.ctx;
+			sts = src.sts;
+			src.ctx = nullptr;
+			}
+
+		return	*this;
+	}
+
+	Context	(const Context &) = delete;
+	Context	&operator= (const Context &) = delete;
+
+	~Context () { release(); }
+
+	/* A condition status of the cli$parse() */
+	int	status	() const noexcept { return sts; }
+
+	/* Call verb's action routine */
+	int	dispatch () const noexcept
+	{
+		return	ctx ? cli$dispatch(ctx) : STS$K_FATAL;
+	}
+
+private:
+	int	sts;
+
+	void	release	() noexcept
+	{
+		if ( ctx )
+			cli$cleanup(ctx);
+
+		ctx = nullptr;
+	}
+};
+
+/*
+ * Bind a callable object as the verb's action routine: int fn(cli::ContextView),
+ * the object is referenced (not copied), so it must outlive the verbs table usage.
+ */
+template <typename F> int	_thunk	(CLI_CTX *clictx, void *arg)
+{
+	return	(*static_cast<F *>(arg))(ContextView(clictx));
+}
+
+template <typename F> void	bind	(CLI_VERB &verb, F &fn) noexcept
+{
+	static_assert(std::is_invocable_r_v<int, F &, ContextView>, "Action routine must be: int (cli::ContextView)");
+
+	verb.act_rtn = reinterpret_cast<int (*) (__unknown_params)>(&_thunk<F>);
+	verb.act_arg = static_cast<void *>(&fn);
+}
+
+}	/* namespace cli */
+
+#endif	/* __CLI$ROUTINES_HPP__ */
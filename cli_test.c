@@ -0,0 +1,1263 @@
+#define	__MODULE__	"CLI_TEST"
+#define	__IDENT__	"X.00-01"
+
+/*
+**++
+**
+**  FACILITY:  Command Language Interface (CLI) Routines
+**
+**  ABSTRACT: Regression tests of the CLI Routines.
+**
+**  DESCRIPTION: Every test is a routine returns a number of failed checks, tests are run in order,
+**	the program exits with a non-zero code if any check has been failed. Build by cli_test.pro.
+**
+**  AUTHORS: Ruslan R. Laishev (RRL)
+**
+**  CREATION DATE:  19-OCT-2026
+**
+**  MODIFICATION HISTORY:
+**
+**--
+*/
+
+#include	<string.h>
+#include	<strings.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<errno.h>
+#include	<fcntl.h>
+#include	<unistd.h>
+#include	<pthread.h>
+#include	<sched.h>
+#include	<malloc.h>
+#include	<sys/stat.h>
+
+#define		__FAC__	"CLI_TEST"
+#define		__TFAC__ __FAC__ ": "
+#include	"utility_routines.h"
+#include	"cli_routines.h"
+
+#define	$CHECK(cond)	( (cond) ? 0 : (fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond), 1) )
+
+static	int	test_action	( CLI_CTX *clictx, void *arg)
+{
+	return	STS$K_SUCCESS;
+}
+
+static	CLI_PQDESC	dev_params [] = {
+			{.pn = CLI$K_P1, .type = CLI$K_DEVICE, .name = {$ASCINI("Device")} },
+			{0}},
+		dev_quals [] = {
+			{ .name = {$ASCINI("FULL")},	CLI$K_OPT},
+			{ .name = {$ASCINI("COUNT")},	CLI$K_NUM},
+			{ .name = {$ASCINI("SINCE")},	CLI$K_DATE},
+			{0}};
+
+static	CLI_VERB	test_verbs [] = {
+			{ .name = {$ASCINI("volume")}, .params = dev_params, .quals = dev_quals, .act_rtn = test_action},
+			{0}};
+
+/*
+ * Idempotent verb: a slow action routine counts its calls
+ */
+static	int	cache_calls;
+
+static	int	cache_action	( CLI_CTX *clictx, void *arg)
+{
+const char *names[] = {"VALUE"}, *vals[] = {"42"};
+
+	__atomic_add_fetch(&cache_calls, 1, __ATOMIC_RELAXED);
+	usleep(200 * 1000);
+
+	cli$put_header(clictx, 1, names, NULL);
+
+	return	cli$put_output(clictx, 1, vals);
+}
+
+static	CLI_PQDESC	cache_quals [] = {
+			{ .name = {$ASCINI("FULL")},	CLI$K_OPT},
+			{ .name = {$ASCINI("COUNT")},	CLI$K_NUM},
+			{0}};
+
+static	CLI_VERB	cache_verbs [] = {
+			{ .name = {$ASCINI("status")}, .quals = cache_quals, .act_rtn = cache_action, .flags = CLI$M_VERB_IDEMPOTENT, .ttl = 5000},
+			{0}};
+
+static	int	cache_run	(int argc, char **argv, int msecs)
+{
+void	*clictx = NULL;
+int	status, fd = open("/dev/null", O_WRONLY);
+
+	if ( 1 & (status = cli$parse(cache_verbs, 0, argc, argv, &clictx)) )
+		{
+		cli$set_output(clictx, fd, CLI$K_OUT_TEXT);
+
+		if ( msecs )
+			cli$set_deadline(clictx, msecs);
+
+		status = cli$dispatch(clictx);
+		}
+
+	if ( clictx )
+		cli$cleanup(clictx);
+
+	close(fd);
+
+	return	status;
+}
+
+static	void	*cache_leader	( void *arg)
+{
+char	*argv[] = {"status", "/full", "/count=1"};
+
+	*((int *) arg) = cache_run(3, argv, 0);
+
+	return	NULL;
+}
+
+/*
+ * A coalesced command with a deadline waits for the leader's result,
+ * qualifiers' order and number's notation don't change the cache key.
+ */
+static	int	test_cache_coalesce	(void)
+{
+int	fails = 0, lsts = 0, status;
+pthread_t tid;
+char	*argv[] = {"status", "/count=0x1", "/full"};
+CLI_CACHESTAT	stat;
+
+	cli$cache_invalidate(NULL);
+	cache_calls = 0;
+
+	pthread_create(&tid, NULL, cache_leader, &lsts);
+	usleep(50 * 1000);
+
+	status = cache_run(3, argv, 5000);
+	pthread_join(tid, NULL);
+
+	cli$cache_stat(&stat);
+
+	fails += $CHECK( 1 & lsts );
+	fails += $CHECK( 1 & status );
+	fails += $CHECK( cache_calls == 1 );
+	fails += $CHECK( stat.coalesced >= 1 );
+
+	/* Served from the cache */
+	fails += $CHECK( 1 & cache_run(3, argv, 0) );
+	fails += $CHECK( cache_calls == 1 );
+
+	return	fails;
+}
+
+/*
+ * Cached results are dropped by the verb path after the table has been updated,
+ * a path is matched by whole names
+ */
+static	CLI_PQDESC	cache_newqual = { .name = {$ASCINI("BRIEF")},	CLI$K_OPT};
+
+static	int	cache_run_tbl	(CLI_TABLE *tbl)
+{
+char	*argv[] = {"status", "/full"};
+void	*clictx = NULL;
+int	status, slot, fd = open("/dev/null", O_WRONLY);
+CLI_VERB *verbs = cli$tbl_enter(tbl, &slot);
+
+	if ( 1 & (status = cli$parse(verbs, 0, 2, argv, &clictx)) )
+		{
+		cli$set_output(clictx, fd, CLI$K_OUT_TEXT);
+		status = cli$dispatch(clictx);
+		}
+
+	cli$cleanup(clictx);
+	cli$tbl_leave(tbl, slot);
+	close(fd);
+
+	return	status;
+}
+
+static	int	test_cache_invalidate	(void)
+{
+int	fails = 0;
+CLI_TABLE *tbl = NULL;
+
+	cli$cache_invalidate(NULL);
+	cache_calls = 0;
+
+	if ( !(1 & cli$tbl_init(&tbl, cache_verbs)) )
+		return	1;
+
+	fails += $CHECK( 1 & cache_run_tbl(tbl) );
+	fails += $CHECK( 1 & cache_run_tbl(tbl) );
+	fails += $CHECK( cache_calls == 1 );
+
+	/* The verbs array is replaced, the cached result is still found by names */
+	fails += $CHECK( 1 & cli$tbl_add_qual(tbl, "status", &cache_newqual) );
+	fails += $CHECK( 1 & cache_run_tbl(tbl) );
+	fails += $CHECK( cache_calls == 1 );
+
+	/* Not a whole name: nothing is dropped */
+	cli$cache_invalidate("stat");
+	fails += $CHECK( 1 & cache_run_tbl(tbl) );
+	fails += $CHECK( cache_calls == 1 );
+
+	cli$cache_invalidate(" STATUS ");
+	fails += $CHECK( 1 & cache_run_tbl(tbl) );
+	fails += $CHECK( cache_calls == 2 );
+
+	cli$tbl_free(tbl);
+	cli$cache_invalidate(NULL);
+
+	return	fails;
+}
+
+/*
+ * Allocation failure injection: realloc() of a large block fails on demand, calloc() fails
+ * once a countdown is expired, the allocator cannot be replaced under sanitizers.
+ */
+#if	!defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define	__FAILALLOC__	1
+
+extern	void	*__libc_realloc (void *ptr, size_t size);
+extern	void	*__libc_calloc (size_t nmemb, size_t size);
+static	int	fail_realloc, fail_calloc;
+
+void	*calloc	(size_t nmemb, size_t size)
+{
+	if ( __atomic_load_n(&fail_calloc, __ATOMIC_RELAXED) && !__atomic_sub_fetch(&fail_calloc, 1, __ATOMIC_RELAXED) )
+		{
+		errno = ENOMEM;
+		return	NULL;
+		}
+
+	return	__libc_calloc(nmemb, size);
+}
+
+void	*realloc	(void *ptr, size_t size)
+{
+	if ( __atomic_load_n(&fail_realloc, __ATOMIC_RELAXED) && (size > 1024 * 1024) )
+		{
+		errno = ENOMEM;
+		return	NULL;
+		}
+
+	return	__libc_realloc(ptr, size);
+}
+#endif
+
+static	int	pipe_asts, pipe_fatals, pipe_nulls;
+
+static	void	pipe_ast	( CLI_CTX *clictx, int status, void *arg)
+{
+	pipe_asts++;
+	pipe_nulls += !clictx;
+	pipe_fatals += (status == STS$K_FATAL);
+}
+
+/*
+ * Every submitted command reaches the completion routine, a command cannot be queued
+ * because of allocation failure is passed through the stages as failed.
+ */
+static	int	test_pipe_submit	(void)
+{
+int	fails = 0, i, status, len = 2 * 1024 * 1024;
+CLI_PIPE *pipe = NULL;
+CLI_PIPECFG cfg = {.depth = 4, .cpus = {-1, -1, -1}};
+char	*big, line[] = "volume /dev/null /full";
+
+	if ( !(big = malloc(len)) )
+		return	$CHECK( big != NULL );
+
+	memset(big, 'x', len);
+	pipe_asts = pipe_fatals = pipe_nulls = 0;
+
+	fails += $CHECK( 1 & cli$pipe_init(&pipe, test_verbs, &cfg, pipe_ast) );
+
+	for ( i = 0; pipe && (i < 1000); i++)
+		{
+		if ( i != 500 )
+			{
+			fails += $CHECK( 1 & cli$pipe_submit(pipe, line, strlen(line), NULL) );
+			continue;
+			}
+
+#ifdef	__FAILALLOC__
+		__atomic_store_n(&fail_realloc, 1, __ATOMIC_RELAXED);
+		status = cli$pipe_submit(pipe, big, len, NULL);
+		__atomic_store_n(&fail_realloc, 0, __ATOMIC_RELAXED);
+
+		fails += $CHECK( status == STS$K_FATAL );
+#else
+		status = cli$pipe_submit(pipe, big, len, NULL);
+#endif
+		}
+
+	if ( pipe )
+		cli$pipe_free(pipe);
+
+	fails += $CHECK( pipe_asts == 1000 );
+
+#ifdef	__FAILALLOC__
+	fails += $CHECK( (pipe_fatals == 1) && (pipe_nulls == 1) );
+#endif
+
+	free(big);
+
+	return	fails;
+}
+
+/*
+ * Removed verbs give back their subverbs and qualifiers arrays, a failed update
+ * leaves nothing behind; the heap must not grow over add/delete cycles.
+ */
+static	CLI_PQDESC	tbl_qual = { .name = {$ASCINI("BRIEF")},	CLI$K_OPT};
+static	CLI_VERB	tbl_verb = { .name = {$ASCINI("tblx")}, .act_rtn = test_action},
+			tbl_subverb = { .name = {$ASCINI("tbly")}, .quals = dev_quals, .act_rtn = test_action};
+
+static	void	tbl_cycle	(CLI_TABLE *tbl, int failat)
+{
+#ifdef	__FAILALLOC__
+	__atomic_store_n(&fail_calloc, failat, __ATOMIC_RELAXED);
+#endif
+	cli$tbl_add_verb(tbl, "", &tbl_verb);
+	cli$tbl_add_verb(tbl, "tblx", &tbl_subverb);
+	cli$tbl_add_qual(tbl, "tblx tbly", &tbl_qual);
+	cli$tbl_del_qual(tbl, "tblx tbly", "FULL");
+#ifdef	__FAILALLOC__
+	__atomic_store_n(&fail_calloc, 0, __ATOMIC_RELAXED);
+#endif
+	cli$tbl_del_verb(tbl, "tblx");
+}
+
+static	int	test_tbl_reclaim	(void)
+{
+int	fails = 0, i;
+CLI_TABLE *tbl = NULL;
+CLI_VERB *verbs;
+#ifdef	__FAILALLOC__
+size_t	used;
+#endif
+
+	fails += $CHECK( 1 & cli$tbl_init(&tbl, test_verbs) );
+
+	for ( i = 0; tbl && (i < 16); i++)
+		tbl_cycle(tbl, i % 8);
+
+#ifdef	__FAILALLOC__
+	used = mallinfo2().uordblks;
+#endif
+
+	for ( i = 0; tbl && (i < 4096); i++)
+		tbl_cycle(tbl, i % 8);
+
+#ifdef	__FAILALLOC__
+	fails += $CHECK( mallinfo2().uordblks <= used + 4096 );
+#endif
+
+	if ( tbl )
+		{
+		verbs = cli$tbl_enter(tbl, &i);
+		fails += $CHECK( $ASCLEN(&verbs[1].name) == 0 );
+		cli$tbl_leave(tbl, i);
+
+		cli$tbl_free(tbl);
+		}
+
+	return	fails;
+}
+
+/*
+ * Stubs are bound at first use while the table is updated by other thread: the table's
+ * arrays must not be written by parsers. The program is linked with -rdynamic, an empty
+ * name of the shared object is referring to the program itself.
+ */
+static	int	plugin_calls;
+
+static	int	plugin_action	( CLI_CTX *clictx, void *arg)
+{
+	__atomic_add_fetch(&plugin_calls, 1, __ATOMIC_RELAXED);
+
+	return	STS$K_SUCCESS;
+}
+
+CLI_VERB	test_plugin = { .name = {$ASCINI("plug")}, .quals = dev_quals, .act_rtn = plugin_action};
+
+static	CLI_VERB	plugin_verbs [] = {
+			{ .name = {$ASCINI("plug")}, .shlib = "", .shsym = "test_plugin"},
+			{ .name = {$ASCINI("nosym")}, .shlib = "", .shsym = "no_such_symbol"},
+			{0}};
+
+static	CLI_TABLE	*plugin_tbl;
+static	int	plugin_fails;
+
+static	void	*plugin_parser	(void *arg)
+{
+int	i, slot, status;
+void	*clictx;
+CLI_VERB *verbs;
+char	*argv[] = {"plug", "/full"}, *badv[] = {"nosym"};
+
+	for ( i = 0; i < 2000; i++)
+		{
+		verbs = cli$tbl_enter(plugin_tbl, &slot);
+		clictx = NULL;
+
+		if ( 1 & (status = cli$parse(verbs, 0, 2, argv, &clictx)) )
+			status = cli$dispatch(clictx);
+
+		if ( clictx )
+			cli$cleanup(clictx);
+
+		__atomic_add_fetch(&plugin_fails, !(1 & status), __ATOMIC_RELAXED);
+
+		clictx = NULL;
+		status = cli$parse(verbs, 0, 1, badv, &clictx);
+
+		if ( clictx )
+			cli$cleanup(clictx);
+
+		__atomic_add_fetch(&plugin_fails, (1 & status), __ATOMIC_RELAXED);
+
+		cli$tbl_leave(plugin_tbl, slot);
+		}
+
+	return	NULL;
+}
+
+static	int	test_plugin_bind	(void)
+{
+int	fails = 0, i, slot;
+pthread_t tids[2];
+CLI_VERB *verbs;
+
+	plugin_calls = plugin_fails = 0;
+
+	if ( !(1 & cli$tbl_init(&plugin_tbl, plugin_verbs)) )
+		return	$CHECK( plugin_tbl != NULL );
+
+	for ( i = 0; i < 2; i++)
+		fails += $CHECK( !pthread_create(&tids[i], NULL, plugin_parser, NULL) );
+
+	for ( i = 0; i < 2000; i++)
+		{
+		cli$tbl_add_verb(plugin_tbl, "", &tbl_verb);
+		cli$tbl_del_verb(plugin_tbl, "tblx");
+		}
+
+	for ( i = 0; i < 2; i++)
+		pthread_join(tids[i], NULL);
+
+	fails += $CHECK( plugin_fails == 0 );
+	fails += $CHECK( plugin_calls == 2 * 2000 );
+
+	/* Stubs are left intact */
+	verbs = cli$tbl_enter(plugin_tbl, &slot);
+	fails += $CHECK( !verbs[0].bound && !verbs[0].act_rtn && !verbs[0].quals );
+	cli$tbl_leave(plugin_tbl, slot);
+
+	fails += $CHECK( !plugin_verbs[0].bound && !plugin_verbs[0].act_rtn );
+
+	cli$tbl_free(plugin_tbl);
+
+	return	fails;
+}
+
+/*
+ * Cached help is invalidated by the stub's binding, 64-bit keyword values are rendered in full
+ */
+static	CLI_KEYWORD	help_kwds [] = {
+			{ {$ASCINI("HIGH")}, 0x100000000ULL},
+			{0}};
+
+static	CLI_PQDESC	help_quals [] = {
+			{ .name = {$ASCINI("LEVEL")}, .type = CLI$K_KWD, .kwd = help_kwds},
+			{0}};
+
+static	CLI_VERB	help_verbs [] = {
+			{ .name = {$ASCINI("hplug")}, .shlib = "", .shsym = "test_plugin"},
+			{ .name = {$ASCINI("level")}, .quals = help_quals, .act_rtn = test_action},
+			{0}};
+
+static	int	test_help_cache	(void)
+{
+int	fails = 0, len;
+char	buf[4096], *argv[] = {"hplug"};
+CLI_CTX	*clictx = NULL;
+
+	fails += $CHECK( 1 & cli$render_help(help_verbs, 0, CLI$K_FMT_TEXT, buf, sizeof(buf), &len) );
+	fails += $CHECK( strstr(buf, "not loaded") && strstr(buf, "HIGH=0x100000000") );
+
+	fails += $CHECK( 1 & cli$render_help(help_verbs, 0, CLI$K_FMT_JSON, buf, sizeof(buf), &len) );
+	fails += $CHECK( strstr(buf, "\"value\":4294967296") != NULL );
+
+	fails += $CHECK( 1 & cli$parse(help_verbs, 0, 1, argv, (void **) &clictx) );
+
+	if ( clictx )
+		cli$cleanup(clictx);
+
+	fails += $CHECK( 1 & cli$render_help(help_verbs, 0, CLI$K_FMT_TEXT, buf, sizeof(buf), &len) );
+	fails += $CHECK( !strstr(buf, "not loaded") && strstr(buf, "/FULL") );
+
+	return	fails;
+}
+
+/*
+ * An exact match is selected even if shortened matches precede it in the table
+ */
+static	CLI_PQDESC	exact_quals [] = {
+			{ .name = {$ASCINI("FULLNAME")},	CLI$K_OPT},
+			{ .name = {$ASCINI("FULLY")},	CLI$K_OPT},
+			{ .name = {$ASCINI("FULL")},	CLI$K_OPT},
+			{0}};
+
+static	CLI_VERB	exact_verbs [] = {
+			{ .name = {$ASCINI("setx")}, .act_rtn = test_action},
+			{ .name = {$ASCINI("setup")}, .act_rtn = test_action},
+			{ .name = {$ASCINI("set")}, .quals = exact_quals, .act_rtn = test_action},
+			{0}};
+
+static	int	exact_parse	(int argc, char **argv, int *reason)
+{
+CLI_CTX	*clictx = NULL;
+int	status;
+
+	status = cli$parse(exact_verbs, 0, argc, argv, (void **) &clictx);
+	*reason = clictx ? clictx->err.reason : -1;
+
+	if ( clictx )
+		cli$cleanup(clictx);
+
+	return	status;
+}
+
+static	int	test_exact_match	(void)
+{
+int	fails = 0, reason;
+char	*exact[] = {"set", "/full"}, *prefix[] = {"se"}, *qprefix[] = {"set", "/fu"};
+
+	fails += $CHECK( 1 & exact_parse(2, exact, &reason) );
+	fails += $CHECK( !(1 & exact_parse(1, prefix, &reason)) && (reason == CLI$K_ERR_AMBIGUOUS) );
+	fails += $CHECK( !(1 & exact_parse(2, qprefix, &reason)) && (reason == CLI$K_ERR_AMBIGUOUS) );
+
+	return	fails;
+}
+
+/*
+ * An abandoned routine keeps failing on output while the caller is reading the error record,
+ * the caller must see only the timeout.
+ */
+static	int	abandon_done;
+
+static	int	abandon_action	( CLI_CTX *clictx, void *arg)
+{
+const char *names[] = {"VALUE"}, *vals[] = {"42"};
+unsigned long long i;
+
+	/* Ignore cancellation for a while, output to /dev/full fails with ENOSPC */
+	for ( i = 0; i < 20000; i++)
+		{
+		cli$put_header(clictx, 1, names, NULL);
+		cli$put_output(clictx, 1, vals);
+		cli$flush_output(clictx);
+
+		if ( !(i % 64) )
+			usleep(1000);
+		}
+
+	__atomic_store_n(&abandon_done, 1, __ATOMIC_RELEASE);
+
+	return	STS$K_SUCCESS;
+}
+
+static	CLI_VERB	abandon_verbs [] = {
+			{ .name = {$ASCINI("spin")}, .act_rtn = abandon_action},
+			{0}};
+
+static	int	test_dispatch_abandon	(void)
+{
+int	fails = 0, status, fd, i, reason = CLI$K_ERR_TIMEOUT;
+CLI_CTX	*clictx = NULL;
+char	*argv[] = {"spin"};
+
+	if ( 0 > (fd = open("/dev/full", O_WRONLY)) )
+		return	0;
+
+	abandon_done = 0;
+
+	fails += $CHECK( 1 & cli$parse(abandon_verbs, 0, 1, argv, (void **) &clictx) );
+
+	if ( clictx )
+		{
+		cli$set_output(clictx, fd, CLI$K_OUT_TEXT);
+
+		status = cli$dispatch_timed(clictx, 20, CLI$M_DSP_ABANDON);
+		fails += $CHECK( !(1 & status) );
+
+		for ( i = 0; !__atomic_load_n(&abandon_done, __ATOMIC_ACQUIRE) && (reason == CLI$K_ERR_TIMEOUT); i++)
+			reason = clictx->err.reason;
+
+		fails += $CHECK( reason == CLI$K_ERR_TIMEOUT );
+
+		cli$cleanup(clictx);
+		}
+
+	while ( !__atomic_load_n(&abandon_done, __ATOMIC_ACQUIRE) )
+		usleep(1000);
+
+	/* The routine's thread releases the context right after */
+	usleep(50 * 1000);
+	close(fd);
+
+	return	fails;
+}
+
+/*
+ * Contexts cached by the thread are returned to their pool at switching to other pool,
+ * a pool with contexts in use cannot be released
+ */
+static	int	test_ctx_pool	(void)
+{
+int	fails = 0, i;
+CLI_CTXPOOL *pa = NULL, *pb = NULL;
+CLI_POOLSTAT stat;
+CLI_CTX	*ctxs[4] = {0}, *clictx = NULL;
+char	*argv[] = {"setup"};
+
+	fails += $CHECK( 1 & cli$ctx_pool_init(&pa, 4, 4) );
+	fails += $CHECK( 1 & cli$ctx_pool_init(&pb, 4, 4) );
+
+	if ( !pa || !pb )
+		return	fails;
+
+	cli$ctx_pool(pa);
+	fails += $CHECK( 1 & cli$parse(exact_verbs, 0, 1, argv, (void **) &clictx) );
+	cli$cleanup(clictx);
+
+	cli$ctx_pool(pb);
+	fails += $CHECK( 1 & cli$parse(exact_verbs, 0, 1, argv, (void **) &clictx) );
+
+	/* A context is in use */
+	fails += $CHECK( !(1 & cli$ctx_pool_free(pb)) );
+	cli$cleanup(clictx);
+
+	/* All contexts of the first pool are available again */
+	cli$ctx_pool(pa);
+
+	for ( i = 0; i < 4; i++)
+		fails += $CHECK( 1 & cli$parse(exact_verbs, 0, 1, argv, (void **) &ctxs[i]) );
+
+	cli$ctx_pool_stat(pa, &stat);
+	fails += $CHECK( stat.misses == 0 );
+
+	for ( i = 0; i < 4; i++)
+		if ( ctxs[i] )
+			cli$cleanup(ctxs[i]);
+
+	cli$ctx_pool(NULL);
+	fails += $CHECK( 1 & cli$ctx_pool_free(pa) );
+	fails += $CHECK( 1 & cli$ctx_pool_free(pb) );
+
+	return	fails;
+}
+
+/*
+ * A pool is released while other threads are parsing: a pool still in use can refuse,
+ * but nobody must touch a released pool
+ */
+static	int	pool_stop;
+
+static	void	*pool_parser	( void *arg)
+{
+char	*argv[] = {"setup"};
+CLI_CTX	*clictx;
+int	*fails = arg;
+
+	while ( !__atomic_load_n(&pool_stop, __ATOMIC_ACQUIRE) )
+		{
+		clictx = NULL;
+		*fails += $CHECK( 1 & cli$parse(exact_verbs, 0, 1, argv, (void **) &clictx) );
+		cli$cleanup(clictx);
+		}
+
+	return	NULL;
+}
+
+static	int	test_ctx_pool_race	(void)
+{
+int	fails = 0, tfails[4] = {0}, i, round;
+pthread_t tids[4];
+CLI_CTXPOOL *pool;
+
+	for ( i = 0; i < 4; i++)
+		pthread_create(&tids[i], NULL, pool_parser, &tfails[i]);
+
+	for ( round = 0; round < 200; round++)
+		{
+		if ( !(1 & cli$ctx_pool_init(&pool, 8, 4)) )
+			{
+			fails++;
+			break;
+			}
+
+		cli$ctx_pool(pool);
+		usleep(100);
+
+		/* Refused while contexts are in use, detach and wait for their release */
+		if ( !(1 & cli$ctx_pool_free(pool)) )
+			{
+			cli$ctx_pool(NULL);
+
+			while ( !(1 & cli$ctx_pool_free(pool)) )
+				sched_yield();
+			}
+		}
+
+	__atomic_store_n(&pool_stop, 1, __ATOMIC_RELEASE);
+
+	for ( i = 0; i < 4; i++)
+		{
+		pthread_join(tids[i], NULL);
+		fails += tfails[i];
+		}
+
+	return	fails;
+}
+
+/*
+ * A DEVICE value of the maximum length must be rejected without overflow of the path buffer
+ */
+/* Parse "volume /dev/null <prefix><fill...>" with a value of 'len' octets */
+static	int	test_maxlen_qual	(const char *prefix, char fill, int len, int valid)
+{
+char	arg [ASC$K_SZ + 32], *argv[3] = {"volume", "/dev/null", arg}, *vp;
+void	*clictx = NULL;
+int	fails = 0, status, plen = strchr(prefix, '=') + 1 - prefix;
+
+	strcpy(arg, prefix);
+	vp = arg + strlen(arg);
+	memset(vp, fill, len - (vp - arg - plen));
+	arg[plen + len] = '\0';
+
+	status = cli$parse(test_verbs, 0, 3, argv, &clictx);
+
+	if ( valid )
+		fails += $CHECK( 1 & status );
+	else	fails += $CHECK( !(1 & status) && (((CLI_CTX *) clictx)->err.reason == CLI$K_ERR_BADVALUE) );
+
+	if ( fails )
+		fprintf(stderr, "'%s', %d octets\n", prefix, len);
+
+	cli$cleanup(clictx);
+
+	return	fails;
+}
+
+static	int	test_device_maxlen	(void)
+{
+int	fails = 0, len, status;
+static const int lens[] = {250, 251, 254, ASC$K_SZ, ASC$K_SZ + 16};
+char	val [ASC$K_SZ + 32], *argv[2] = {"volume", val};
+void	*clictx;
+unsigned i;
+
+	for ( i = 0; i < sizeof(lens) / sizeof(lens[0]); i++)
+		{
+		len = lens[i];
+		memset(val, 'a', len);
+		val[len] = '\0';
+
+		clictx = NULL;
+		status = cli$parse(test_verbs, 0, 2, argv, &clictx);
+
+		fails += $CHECK( !(1 & status) );
+		fails += $CHECK( clictx && (((CLI_CTX *) clictx)->err.reason == CLI$K_ERR_BADVALUE) );
+
+		if ( clictx )
+			cli$cleanup(clictx);
+		}
+
+	/* An existing device is still accepted */
+	strcpy(val, "/dev/null");
+	clictx = NULL;
+	fails += $CHECK( 1 & cli$parse(test_verbs, 0, 2, argv, &clictx) );
+	cli$cleanup(clictx);
+
+	/* Values of the maximum length fill the ASC, they are checked by their length only */
+	fails += test_maxlen_qual("/count=", '0', ASC$K_SZ, 1);
+	fails += test_maxlen_qual("/count=", '0', ASC$K_SZ - 1, 1);
+	fails += test_maxlen_qual("/count=", '9', ASC$K_SZ, 0);
+	fails += test_maxlen_qual("/since=01-01-2026 ", ' ', ASC$K_SZ, 1);
+	fails += test_maxlen_qual("/since=", 'x', ASC$K_SZ, 0);
+
+	return	fails;
+}
+
+/*
+ * A keyword list in parentheses, every element is checked, an unbalanced list is rejected
+ */
+static	CLI_KEYWORD	list_kwds [] = {
+			{ {$ASCINI("FULL")}, 1},
+			{ {$ASCINI("TRACE")}, 2},
+			{ {$ASCINI("ERROR")}, 4},
+			{0}};
+
+static	CLI_PQDESC	list_quals [] = {
+			{ .name = {$ASCINI("LOGGING")},	.type = CLI$K_KWD, .flag = CLI$M_LIST, .kwd = list_kwds},
+			{0}};
+
+static	CLI_VERB	list_verbs [] = {
+			{ .name = {$ASCINI("diff")}, .quals = list_quals, .act_rtn = test_action},
+			{0}};
+
+static	int	list_mask	(char *qual, int *mask)
+{
+char	*argv[] = {"diff", qual};
+void	*clictx = NULL;
+CLI_LIST *list;
+ASC	val;
+int	status, i;
+
+	*mask = 0;
+
+	if ( (1 & (status = cli$parse(list_verbs, 0, 2, argv, &clictx)))
+		&& (1 & (status = cli$list_open(clictx, list_quals, &list))) )
+		{
+		while ( 1 & (status = cli$list_next(list, &val)) )
+			for ( i = 0; $ASCLEN(&list_kwds[i].name); i++ )
+				if ( $ASCLEN(&val) && !strncasecmp($ASCPTR(&val), $ASCPTR(&list_kwds[i].name), $ASCLEN(&val)) )
+					*mask |= list_kwds[i].val;
+
+		cli$list_close(list);
+		}
+
+	if ( clictx )
+		cli$cleanup(clictx);
+
+	return	status;
+}
+
+static	int	test_list_parens	(void)
+{
+int	fails = 0, mask;
+
+	fails += $CHECK( (STS$K_WARN == list_mask("/logging=(full,tr)", &mask)) && (mask == 3) );
+	fails += $CHECK( (STS$K_WARN == list_mask("/logging=error", &mask)) && (mask == 4) );
+	fails += $CHECK( (STS$K_WARN == list_mask("/logging=()", &mask)) && !mask );
+	fails += $CHECK( !(1 & list_mask("/logging=(full", &mask)) );
+	fails += $CHECK( !(1 & list_mask("/logging=(full,bogus)", &mask)) && (mask == 1) );
+
+	return	fails;
+}
+
+/*
+ * A command is replayed with the recorded options: a value isn't checked if it was deferred at recording
+ */
+static	int	test_replay_opts	(void)
+{
+int	fails = 0;
+char	fspec[] = "/tmp/cli_test_XXXXXX", *argv[2] = {"volume", "/dev/no-such-device"};
+void	*clictx = NULL;
+CLI_REPLAYSTAT stat;
+
+	close(mkstemp(fspec));
+
+	fails += $CHECK( 1 & cli$record_start(fspec) );
+	fails += $CHECK( 1 & cli$parse(test_verbs, CLI$M_OPDEFERVAL, 2, argv, &clictx) );
+	cli$cleanup(clictx);
+	fails += $CHECK( 1 & cli$record_stop() );
+
+	fails += $CHECK( 1 & cli$replay(test_verbs, 0, fspec, 0, &stat) );
+	fails += $CHECK( (stat.nrecs == 1) && !stat.nmismatch );
+
+	unlink(fspec);
+
+	return	fails;
+}
+
+/*
+ * An error record points to the offending text: "volume /dev/null /count=12x", the value starts at offset 24;
+ * an empty command line gets a context with the error record too
+ */
+static	int	test_error_record	(void)
+{
+int	fails = 0, status;
+char	*argv[] = {"volume", "/dev/null", "/count=12x"}, msg[256];
+CLI_CTX	*clictx = NULL;
+
+	status = cli$parse(test_verbs, 0, 3, argv, (void **) &clictx);
+
+	fails += $CHECK( !(1 & status) && clictx );
+	fails += $CHECK( clictx->err.reason == CLI$K_ERR_BADVALUE );
+	fails += $CHECK( (clictx->err.dtype == CLI$K_QUAL) && (clictx->err.desc == &dev_quals[1]) );
+	fails += $CHECK( (clictx->err.tokidx == 2) && (clictx->err.offset == 24) );
+	fails += $CHECK( ($ASCLEN(&clictx->err.text) == 3) && !memcmp($ASCPTR(&clictx->err.text), "12x", 3) );
+
+	cli$format_error(clictx, msg, sizeof(msg));
+	fails += $CHECK( strstr(msg, "'12x'") && strstr(msg, "offset 24") );
+	cli$cleanup(clictx);
+
+	clictx = (CLI_CTX *) &fails;	/* A garbage must be overwritten */
+	status = cli$parse(test_verbs, 0, 0, argv, (void **) &clictx);
+
+	fails += $CHECK( !(1 & status) && (clictx != (CLI_CTX *) &fails) );
+	fails += $CHECK( (clictx != (CLI_CTX *) &fails) && (clictx->err.reason == CLI$K_ERR_NOVERB) && !clictx->err.tokidx );
+
+	if ( clictx != (CLI_CTX *) &fails )
+		cli$cleanup(clictx);
+
+	return	fails;
+}
+
+/*
+ * Every lexer's kernel splits a text the same way as a naive splitter: random texts of spaces,
+ * quotes and letters, lengths are crossing 64 octets blocks
+ */
+static	int	lex_naive	(const char *buf, int len, CLI_TOKEN *toks)
+{
+int	i, ntoks = 0, inq = 0, intok = 0, ws;
+
+	for ( i = 0; i < len; i++)
+		{
+		ws = !inq && strchr(" \t\r\n", buf[i]) && buf[i];
+		inq ^= (buf[i] == '"');
+
+		if ( !ws && !intok )
+			toks[ntoks].off = i, intok = 1;
+		else if ( ws && intok )
+			toks[ntoks].len = i - toks[ntoks].off, ntoks++, intok = 0;
+		}
+
+	if ( intok )
+		toks[ntoks].len = len - toks[ntoks].off, ntoks++;
+
+	return	ntoks;
+}
+
+static	int	test_lex_kernels	(void)
+{
+static const char chars[] = "  \t\r\n\"\"/=-(),abcXYZ";
+static const int kinds[] = {CLI$K_LEX_SCALAR, CLI$K_LEX_SSE2, CLI$K_LEX_AVX2};
+char	buf[512];
+CLI_TOKEN ref[512], toks[512];
+unsigned long long seed = 1;
+int	fails = 0, i, k, n, len, nref, ntoks;
+
+	for ( k = 0; k < (int) (sizeof(kinds) / sizeof(kinds[0])); k++)
+		{
+		if ( !(1 & cli$lex_set_kernel(kinds[k])) )
+			continue;	/* Not supported by the CPU */
+
+		for ( n = 0; (n < 20000) && !fails; n++)
+			{
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			len = (seed >> 33) % sizeof(buf);
+
+			for ( i = 0; i < len; i++)
+				{
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				buf[i] = chars[(seed >> 33) % (sizeof(chars) - 1)];
+				}
+
+			nref = lex_naive(buf, len, ref);
+			ntoks = cli$lex(buf, len, toks, 512);
+
+			fails += $CHECK( ntoks == nref );
+
+			for ( i = 0; !fails && (i < nref); i++)
+				fails += $CHECK( (toks[i].off == ref[i].off) && (toks[i].len == ref[i].len) );
+
+			if ( fails )
+				fprintf(stderr, "kernel %d, '%.*s'\n", kinds[k], len, buf);
+			}
+		}
+
+	/* Tokens over 'maxtoks' are counted, but not stored */
+	fails += $CHECK( 3 == cli$lex("a b c", 5, toks, 1) );
+	fails += $CHECK( (toks[0].off == 0) && (toks[0].len == 1) );
+
+	cli$lex_set_kernel(CLI$K_LEX_AUTO);
+
+	return	fails;
+}
+
+/*
+ * An incremental session: an edit in the middle of a line keeps statuses of the tokens before it,
+ * the edited token and the rest are re-matched, an unchanged DEVICE value is not checked again
+ */
+static	CLI_PQDESC	ses_params [] = {
+			{.pn = CLI$K_P1, .type = CLI$K_NUM, .name = {$ASCINI("Count")} },
+			{.pn = CLI$K_P2, .type = CLI$K_DEVICE, .name = {$ASCINI("Device")} },
+			{0}};
+
+static	CLI_VERB	ses_verbs [] = {
+			{ .name = {$ASCINI("volume")}, .params = ses_params, .quals = dev_quals, .act_rtn = test_action},
+			{0}};
+
+static	int	test_ses_update	(void)
+{
+char	dir[] = "/tmp/cli_sesXXXXXX", sub[64], dev[64];
+char	*argv[5] = {"volume", "5", dev, "/full"};
+CLI_SESSION *ses = NULL;
+CLI_TOKSTAT tok;
+int	fails = 0, first;
+
+	if ( !mkdtemp(dir) )
+		return	$CHECK( !"mkdtemp()" );
+
+	snprintf(sub, sizeof(sub), "%s/dev", dir);
+	mkdir(sub, 0700);
+	snprintf(dev, sizeof(dev), "%s/dev/null", dir);
+	symlink("/dev/null", dev);
+
+	fails += $CHECK( 1 & cli$ses_init(&ses, ses_verbs, 0) );
+	fails += $CHECK( 1 & cli$ses_update(ses, 4, argv, &first) );
+	fails += $CHECK( first == 0 );
+
+	/* The device is gone, a re-check of its value would fail */
+	unlink(dev);
+
+	/* A bad count: the verb is kept, the device after it is re-matched, but not re-checked */
+	argv[1] = "x";
+	fails += $CHECK( !(1 & cli$ses_update(ses, 4, argv, &first)) );
+	fails += $CHECK( first == 1 );
+	fails += $CHECK( (1 & cli$ses_token(ses, 0, &tok)) && (1 & tok.sts) && (tok.verb == &ses_verbs[0]) );
+	fails += $CHECK( (1 & cli$ses_token(ses, 1, &tok)) && !(1 & tok.sts) && (tok.pqdesc == &ses_params[0]) );
+	fails += $CHECK( (1 & cli$ses_token(ses, 2, &tok)) && (1 & tok.sts) && (tok.pqdesc == &ses_params[1]) );
+	fails += $CHECK( (1 & cli$ses_token(ses, 3, &tok)) && (1 & tok.sts) && (tok.pqdesc == &dev_quals[0]) );
+
+	/* Insert /SINCE before /FULL: the count and the device before the edit keep their status,
+	 * the shifted /FULL is re-matched */
+	argv[3] = "/since=01-01-2026";
+	argv[4] = "/full";
+	fails += $CHECK( !(1 & cli$ses_update(ses, 5, argv, &first)) );
+	fails += $CHECK( first == 3 );
+	fails += $CHECK( (1 & cli$ses_token(ses, 1, &tok)) && !(1 & tok.sts) );
+	fails += $CHECK( (1 & cli$ses_token(ses, 2, &tok)) && (1 & tok.sts) );
+	fails += $CHECK( (1 & cli$ses_token(ses, 3, &tok)) && (1 & tok.sts) && (tok.pqdesc == &dev_quals[2]) );
+	fails += $CHECK( (1 & cli$ses_token(ses, 4, &tok)) && (1 & tok.sts) && (tok.pqdesc == &dev_quals[0]) );
+
+	/* A good count and other text of the same device: now the device is checked again and rejected */
+	argv[1] = "7";
+	snprintf(sub, sizeof(sub), "%s/dev/../dev/null", dir);
+	argv[2] = sub;
+	fails += $CHECK( !(1 & cli$ses_update(ses, 5, argv, &first)) );
+	fails += $CHECK( first == 1 );
+	fails += $CHECK( (1 & cli$ses_token(ses, 1, &tok)) && (1 & tok.sts) );
+	fails += $CHECK( (1 & cli$ses_token(ses, 2, &tok)) && !(1 & tok.sts) && (tok.pqdesc == &ses_params[1]) );
+	fails += $CHECK( (1 & cli$ses_token(ses, 4, &tok)) && (1 & tok.sts) );
+
+	fails += $CHECK( 1 & cli$ses_free(ses) );
+	snprintf(sub, sizeof(sub), "%s/dev", dir);
+	rmdir(sub);
+	rmdir(dir);
+
+	return	fails;
+}
+
+/*
+ * A script of 2048 lines is validated by 1, 4 and 7 threads, bad lines are placed around every
+ * chunk's boundary, errors must be merged in line order with line numbers of the whole file
+ */
+#define	VAL$K_LINES	2048
+
+static	int	test_validate_file	(void)
+{
+static const char *kinds[] = {"volume /dev/null /count=5\n", "volume /dev/null /count=5\r\n", "\n", "! volume /dev/null /count=x\n"};
+static const int nthrs[] = {1, 4, 7};
+char	fspec[] = "/tmp/cli_valXXXXXX", *buf, bad[VAL$K_LINES] = {0};
+int	loff[VAL$K_LINES + 1], kind[VAL$K_LINES], fails = 0, fd, i, k, t, l, size, nerrs;
+CLI_VALERR *errs;
+
+	if ( !(buf = malloc(VAL$K_LINES * 32)) )
+		return	$CHECK( !"malloc()" );
+
+	for ( i = 0, size = 0; i < VAL$K_LINES; i++)
+		{
+		kind[i] = (i % 7 == 3) ? 2 : (i % 11 == 5) ? 3 : (i % 5 == 2) ? 1 : 0;
+		loff[i] = size;
+		size += sprintf(buf + size, "%s", kinds[kind[i]]);
+		}
+
+	loff[VAL$K_LINES] = size;
+
+	/* Break the commands around every boundary: the last one of a chunk and the first one of the next chunk,
+	 * kinds 0 and 1 are commands */
+	for ( t = 0; t < (int) (sizeof(nthrs) / sizeof(nthrs[0])); t++)
+		for ( k = 1; k < nthrs[t]; k++)
+			{
+			for ( l = 0; loff[l + 1] <= (size / nthrs[t]) * k; l++);
+
+			for ( i = l; (i >= 0) && (kind[i] > 1); i--);
+			bad[i] = 1;
+
+			for ( i = l + 1; (i < VAL$K_LINES) && (kind[i] > 1); i++);
+			bad[i] = 1;
+			}
+
+	/* The first and the last commands of the file */
+	for ( i = VAL$K_LINES - 1; kind[i] > 1; i--);
+	bad[0] = bad[i] = 1;
+
+	for ( i = 0; i < VAL$K_LINES; i++)
+		if ( bad[i] )
+			*strchr(buf + loff[i], '5') = 'x';
+
+	if ( 0 > (fd = mkstemp(fspec)) )
+		{
+		free(buf);
+		return	$CHECK( !"mkstemp()" );
+		}
+
+	fails += $CHECK( size == write(fd, buf, size) );
+	close(fd);
+
+	for ( t = 0; t < (int) (sizeof(nthrs) / sizeof(nthrs[0])); t++)
+		{
+		errs = NULL;
+		fails += $CHECK( 1 & cli$validate_file(test_verbs, 0, fspec, nthrs[t], &errs, &nerrs) );
+
+		for ( i = 0, k = 0; i < VAL$K_LINES; i++)
+			{
+			if ( !bad[i] )
+				continue;
+
+			fails += $CHECK( (k < nerrs) && (errs[k].lineno == (unsigned long long) i + 1) );
+			fails += $CHECK( (k < nerrs) && (errs[k].err.reason == CLI$K_ERR_BADVALUE) );
+			k++;
+			}
+
+		fails += $CHECK( k == nerrs );
+
+		if ( fails )
+			fprintf(stderr, "%d threads, %d errors\n", nthrs[t], nerrs);
+
+		free(errs);
+		}
+
+	unlink(fspec);
+	free(buf);
+
+	return	fails;
+}
+
+/*
+ * Scheduler: a batch backlog occupies the only non-reserved worker, an interactive command is
+ * served by the reserved one ahead of the backlog; the backlog is cancelled at cli$sched_free()
+ */
+#define	SCH$K_BATCH	8
+
+static	int	sched_gate, sched_ok, sched_cancelled, sched_other;
+
+static	int	sched_batch	( CLI_CTX *clictx, void *arg)
+{
+	while ( !__atomic_load_n(&sched_gate, __ATOMIC_ACQUIRE) )
+		usleep(1000);
+
+	return	STS$K_SUCCESS;
+}
+
+static	CLI_VERB	sched_verbs [] = {
+			{ .name = {$ASCINI("batch")}, .act_rtn = sched_batch, .sched = CLI$K_SCHED_BATCH},
+			{ .name = {$ASCINI("ask")}, .act_rtn = test_action, .sched = CLI$K_SCHED_INTERACTIVE},
+			{0}};
+
+static	void	sched_ast	( CLI_CTX *clictx, int status, void *arg)
+{
+	if ( 1 & status )
+		__atomic_add_fetch(&sched_ok, 1, __ATOMIC_SEQ_CST);
+	else if ( clictx->err.reason == CLI$K_ERR_CANCELLED )
+		__atomic_add_fetch(&sched_cancelled, 1, __ATOMIC_SEQ_CST);
+	else	__atomic_add_fetch(&sched_other, 1, __ATOMIC_SEQ_CST);
+
+	cli$cleanup(clictx);
+}
+
+static	void	*sched_freer	( void *arg)
+{
+	cli$sched_free(arg);
+
+	return	NULL;
+}
+
+static	int	test_sched_classes	(void)
+{
+CLI_SCHEDCFG cfg = { .nworkers = 2, .reserved = 1 };
+CLI_SCHEDSTAT stat;
+CLI_SCHED *sched = NULL;
+char	*batch[] = {"batch"}, *ask[] = {"ask"};
+void	*clictx;
+pthread_t tid;
+int	fails = 0, i;
+
+	if ( $CHECK( 1 & cli$sched_init(&sched, &cfg) ) )
+		return	1;
+
+	for ( i = 0; i < SCH$K_BATCH; i++)
+		{
+		clictx = NULL;
+		fails += $CHECK( 1 & cli$parse(sched_verbs, 0, 1, batch, &clictx) );
+		fails += $CHECK( 1 & cli$sched_submit(sched, clictx, sched_ast, NULL) );
+		}
+
+	clictx = NULL;
+	fails += $CHECK( 1 & cli$parse(sched_verbs, 0, 1, ask, &clictx) );
+	fails += $CHECK( 1 & cli$sched_submit(sched, clictx, sched_ast, NULL) );
+
+	/* The interactive command is completed while the first batch command is still running */
+	for ( i = 0; (i < 5000) && !__atomic_load_n(&sched_ok, __ATOMIC_SEQ_CST); i++)
+		usleep(1000);
+
+	cli$sched_stat(sched, &stat);
+	fails += $CHECK( sched_ok == 1 );
+	fails += $CHECK( stat.cls[CLI$K_SCHED_INTERACTIVE].completed == 1 );
+	fails += $CHECK( !stat.cls[CLI$K_SCHED_BATCH].completed && (stat.cls[CLI$K_SCHED_BATCH].depth == SCH$K_BATCH - 1) );
+
+	/* Stop the scheduler, then let the running command go: the backlog is cancelled */
+	fails += $CHECK( !pthread_create(&tid, NULL, sched_freer, sched) );
+	usleep(100 * 1000);
+	__atomic_store_n(&sched_gate, 1, __ATOMIC_RELEASE);
+	pthread_join(tid, NULL);
+
+	fails += $CHECK( sched_ok == 2 );
+	fails += $CHECK( sched_cancelled == SCH$K_BATCH - 1 );
+	fails += $CHECK( !sched_other );
+
+	return	fails;
+}
+
+static	struct	{
+	const char	*name;
+	int		(*rtn) (void);
+} tests [] = {
+	{ "device_maxlen",	test_device_maxlen },
+	{ "cache_coalesce",	test_cache_coalesce },
+	{ "cache_invalidate",	test_cache_invalidate },
+	{ "pipe_submit",	test_pipe_submit },
+	{ "tbl_reclaim",	test_tbl_reclaim },
+	{ "plugin_bind",	test_plugin_bind },
+	{ "exact_match",	test_exact_match },
+	{ "help_cache",		test_help_cache },
+	{ "dispatch_abandon",	test_dispatch_abandon },
+	{ "ctx_pool",		test_ctx_pool },
+	{ "ctx_pool_race",	test_ctx_pool_race },
+	{ "list_parens",	test_list_parens },
+	{ "replay_opts",	test_replay_opts },
+	{ "error_record",	test_error_record },
+	{ "lex_kernels",	test_lex_kernels },
+	{ "ses_update",		test_ses_update },
+	{ "validate_file",	test_validate_file },
+	{ "sched_classes",	test_sched_classes },
+	{0}};
+
+int	main	(int argc, char **argv)
+{
+int	i, fails, total = 0;
+
+	for ( i = 0; tests[i].name; i++)
+		{
+		fails = tests[i].rtn();
+		total += fails;
+		printf("%-32s %s\n", tests[i].name, fails ? "FAILED" : "OK");
+		}
+
+	return	total ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = cli_test
+
+SOURCES += \
+    cli_test.c \
+    cli_routines.c \
+    ../SecurityCode/vCloud/utility_routines.c
+
+INCLUDEPATH	+= ../SecurityCode/vCloud/
+INCLUDEPATH	+= ./
+
+LIBS	+= -lpthread -ldl
+
+# Plugin test loads a CLI_VERB record from the program itself
+QMAKE_LFLAGS	+= -rdynamic
+
+HEADERS += \
+    cli_routines.h
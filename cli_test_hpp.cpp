@@ -0,0 +1,181 @@
+#define	__MODULE__	"CLI_TEST_HPP"
+#define	__IDENT__	"X.00-01"
+
+/*
+**++
+**
+**  FACILITY:  Command Language Interface (CLI) Routines
+**
+**  ABSTRACT: Regression tests of the C++ layer over the CLI Routines.
+**
+**  DESCRIPTION: Checks cli::Context, typed accessors cli::ContextView::get<T>() and cli::bind(),
+**	the program exits with a non-zero code if any check has been failed. Must be compiled clean
+**	with -std=c++17 -Wall -Wextra. Build by cli_test_hpp.pro.
+**
+**  AUTHORS: Ruslan R. Laishev (RRL)
+**
+**  CREATION DATE:  19-OCT-2026
+**
+**  MODIFICATION HISTORY:
+**
+**--
+*/
+
+#include	<utility>
+#include	<cstdio>
+
+#define		__FAC__	"CLI_TEST_HPP"
+#define		__TFAC__ __FAC__ ": "
+#include	"cli_routines.hpp"
+
+#define	$CHECK(cond)	( (cond) ? 0 : (std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond), 1) )
+
+/* C++ needs all members in order of declaration: name, type, pn, flag, defval, kwd */
+static	CLI_PQDESC	hpp_params [] = {
+			{ {$ASCINI("Count")},	CLI$K_NUM,	CLI$K_P1, 0, {}, nullptr},
+			{} },
+		hpp_quals [] = {
+			{ {$ASCINI("FULL")},	CLI$K_OPT,	0, 0, {}, nullptr},
+			{ {$ASCINI("ADDRESS")},	CLI$K_IPV4,	0, 0, {}, nullptr},
+			{ {$ASCINI("SINCE")},	CLI$K_DATE,	0, 0, {}, nullptr},
+			{ {$ASCINI("ID")},	CLI$K_UUID,	0, 0, {}, nullptr},
+			{ {$ASCINI("BRIEF")},	CLI$K_OPT,	0, 0, {}, nullptr},
+			{} };
+
+/* Is filled by main(), a null entry terminated */
+static	CLI_VERB	hpp_verbs [2];
+
+static	char	*argv_good [] = {(char *) "show", (char *) "0x1ff", (char *) "/full", (char *) "/address=192.168.1.1",
+			(char *) "/since=17-10-2026-10:20:30", (char *) "/id=0123abcd-4567-89ef-0123-456789ABCDEF"},
+		*argv_bad [] = {(char *) "show", (char *) "12", (char *) "/address=300.1.1.1"};
+
+static	int	test_context	(void)
+{
+int	fails = 0;
+cli::Context	ctx(hpp_verbs, 6, argv_good);
+
+	fails += $CHECK( 1 & ctx.status() );
+	fails += $CHECK( bool(ctx) );
+
+	/* Values as is and presence */
+	fails += $CHECK( ctx.value(hpp_params[0]) == std::string_view("0x1ff") );
+	fails += $CHECK( ctx.present(hpp_quals[0]) && !ctx.present(hpp_quals[4]) );
+	fails += $CHECK( !ctx.value(hpp_quals[4]) );
+
+	/* Ownership is moved, the source doesn't release the CLI-context */
+	cli::Context	other(std::move(ctx));
+
+	fails += $CHECK( !ctx && other && (1 & other.status()) );
+	fails += $CHECK( other.present(hpp_quals[0]) );
+
+	ctx = std::move(other);
+	fails += $CHECK( ctx && !other );
+
+	/* A rejected command keeps an error record */
+	cli::Context	bad(hpp_verbs, 3, argv_bad);
+
+	fails += $CHECK( !(1 & bad.status()) );
+	fails += $CHECK( bad.error() && (bad.error()->reason == CLI$K_ERR_BADVALUE) );
+
+	return	fails;
+}
+
+static	int	test_get	(void)
+{
+int	fails = 0;
+cli::Context	ctx(hpp_verbs, 6, argv_good);
+std::optional<struct in_addr> addr;
+std::optional<struct tm> tm;
+std::optional<cli::uuid> id;
+
+	fails += $CHECK( ctx.get<int>(hpp_params[0]) == 0x1ff );
+	fails += $CHECK( ctx.get<unsigned>(hpp_params[0]) == 0x1ffU );
+	fails += $CHECK( !ctx.get<unsigned char>(hpp_params[0]) );		/* Out of range */
+	fails += $CHECK( !ctx.get<int>(hpp_quals[0]) );				/* No value */
+	fails += $CHECK( !ctx.get<int>(hpp_quals[4]) );				/* Not specified */
+
+	addr = ctx.get<struct in_addr>(hpp_quals[1]);
+	fails += $CHECK( addr && (ntohl(addr->s_addr) == 0xc0a80101U) );
+
+	tm = ctx.get<struct tm>(hpp_quals[2]);
+	fails += $CHECK( tm && (tm->tm_mday == 17) && (tm->tm_mon == 9) && (tm->tm_year == 126) );
+	fails += $CHECK( tm && (tm->tm_hour == 10) && (tm->tm_min == 20) && (tm->tm_sec == 30) );
+
+	id = ctx.get<cli::uuid>(hpp_quals[3]);
+	fails += $CHECK( id && ((*id)[0] == 0x01) && ((*id)[3] == 0xcd) && ((*id)[8] == 0x01) && ((*id)[15] == 0xef) );
+
+	/* A wrong type of conversion */
+	fails += $CHECK( !ctx.get<struct in_addr>(hpp_quals[3]) );
+	fails += $CHECK( !ctx.get<cli::uuid>(hpp_quals[1]) );
+
+	return	fails;
+}
+
+static	int	test_bind	(void)
+{
+int	fails = 0, calls = 0;
+long	count = 0;
+auto	show = [&] (cli::ContextView view) -> int
+	{
+		calls++;
+		count = view.get<long>(hpp_params[0]).value_or(-1);
+
+		return	view.present(hpp_quals[0]) ? STS$K_SUCCESS : STS$K_WARN;
+	};
+
+	cli::bind(hpp_verbs[0], show);
+
+	fails += $CHECK( hpp_verbs[0].act_arg == static_cast<void *>(&show) );
+
+	{
+	cli::Context	ctx(hpp_verbs, 6, argv_good);
+
+	fails += $CHECK( (1 & ctx.status()) && (ctx.dispatch() == STS$K_SUCCESS) );
+	fails += $CHECK( (calls == 1) && (count == 0x1ff) );
+	}
+
+	{
+	cli::Context	ctx(hpp_verbs, 2, argv_good);
+
+	fails += $CHECK( (1 & ctx.status()) && (ctx.dispatch() == STS$K_WARN) );
+	fails += $CHECK( calls == 2 );
+	}
+
+	/* Nothing to dispatch in a moved-from context */
+	cli::Context	ctx(hpp_verbs, 6, argv_good), other(std::move(ctx));
+
+	fails += $CHECK( !(1 & ctx.dispatch()) && (calls == 2) );
+
+	hpp_verbs[0].act_rtn = nullptr;
+	hpp_verbs[0].act_arg = nullptr;
+
+	return	fails;
+}
+
+static	struct	{
+	const char	*name;
+	int		(*rtn) (void);
+} tests [] = {
+	{ "context",		test_context },
+	{ "get",		test_get },
+	{ "bind",		test_bind },
+	{}};
+
+int	main	(void)
+{
+int	i, fails, total = 0;
+
+	hpp_verbs[0].name.len = std::strlen("show");
+	std::memcpy(hpp_verbs[0].name.sts, "show", hpp_verbs[0].name.len);
+	hpp_verbs[0].params = hpp_params;
+	hpp_verbs[0].quals = hpp_quals;
+
+	for ( i = 0; tests[i].name; i++)
+		{
+		fails = tests[i].rtn();
+		total += fails;
+		std::printf("%-32s %s\n", tests[i].name, fails ? "FAILED" : "OK");
+		}
+
+	return	total ? 1 : 0;
+}
@@ -0,0 +1,23 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = cli_test_hpp
+
+SOURCES += \
+    cli_test_hpp.cpp \
+    cli_routines.c \
+    ../SecurityCode/vCloud/utility_routines.c
+
+INCLUDEPATH	+= ../SecurityCode/vCloud/
+INCLUDEPATH	+= ./
+
+LIBS	+= -lpthread -ldl
+
+# The C++ layer must be compiled clean
+QMAKE_CXXFLAGS	+= -Wall -Wextra
+
+HEADERS += \
+    cli_routines.h \
+    cli_routines.hpp